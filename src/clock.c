@@ -43,6 +43,9 @@ void clock_sys_init(void)
 
     // Update the memory timings and use PLL
     SYSCTL->RSCLKCFG |= (SYSCTL_RSCLKCFG_MEMTIMU | SYSCTL_RSCLKCFG_USEPLL);
+
+    // Start counting core clock cycles for cycle-accurate delays
+    utils_cycle_counter_init();
 }
 
 /**
@@ -141,7 +144,7 @@ void clock_timer4a_init(void)
 }
 
 /**
- * @brief Configure timer 5A
+ * @brief Configure timer 5A (one-shot, loaded by the software timers)
  */
 void clock_timer5a_init(void)
 {
@@ -151,7 +154,7 @@ void clock_timer5a_init(void)
     // Configure the timer for interrupts
     TIMER5->CTL  &= ~(TIMER_CTL_TAEN);                      // Disable the timer
     TIMER5->CFG   =  (0);                                   // Clear the configuration
-    TIMER5->TAMR  =  (TIMER_TAMR_TAMR_PERIOD);              // Configure for periodic interrupts
+    TIMER5->TAMR  =  (TIMER_TAMR_TAMR_1_SHOT);              // Configure for a single interrupt per load
     TIMER5->TAILR =  (TIMER_5A_RELOAD_VALUE);               // Set the interval value
     TIMER5->IMR  |=  (TIMER_IMR_TATOIM);                    // Set the interrupt mask
 
@@ -174,27 +177,8 @@ void clock_timer6a_init(void)
     TIMER6->TAILR =  (TIMER_6A_RELOAD_VALUE);               // Set the interval value
     TIMER6->IMR  |=  (TIMER_IMR_TATOIM);                    // Set the interrupt mask
 
-    // Configure the interrupt in the NVIC
-    utils_set_nvic(TIMER_6A_INTERRUPT_NUM, 5);
-}
-
-/**
- * @brief Configure timer 7A
- */
-void clock_timer7c_init(void)
-{
-    // Enable the timer and wait for it to be ready
-    utils_timer_clock_enable(TIMER7);
-
-    // Configure the timer for interrupts
-    TIMER7->CTL  &= ~(TIMER_CTL_TAEN);                      // Disable the timer
-    TIMER7->CFG   =  (0);
-    TIMER7->TAMR  =  (TIMER_TAMR_TAMR_PERIOD);              // Configure for periodic interrupts
-    TIMER7->TAILR =  (TIMER_7C_RELOAD_VALUE);               // Set the interval value
-    TIMER7->IMR  |=  (TIMER_IMR_TATOIM);                    // Set the interrupt mask
-
-    // Configure the interrupt in the NVIC
-    utils_set_nvic(TIMER_7C_INTERRUPT_NUM, 5);
+    // Configure the interrupt in the NVIC (highest priority, so it can sample other handlers)
+    utils_set_nvic(TIMER_6A_INTERRUPT_NUM, 0);
 }
 
 /**
@@ -17,6 +17,10 @@
 // General clock defines
 #define SYSCLOCK_FREQUENCY                      120000000   // 120 MHz
 
+// Time conversions (core clock cycles, rounded up so a wait is never shorter than asked)
+#define CLOCK_NS_TO_CYCLES(ns)                  ((((ns) * (SYSCLOCK_FREQUENCY / 1000000)) + 999) / 1000)
+#define CLOCK_US_TO_CYCLES(us)                  ((us) * (SYSCLOCK_FREQUENCY / 1000000))
+
 // Timer 0 defines
 #define TIMER_0A_PERIOD                         23999       // Calculated for steppers to travel 1 foot/sec
 #define TIMER_0A_RELOAD_VALUE                   (TIMER_0A_PERIOD << NVIC_ST_RELOAD_S)
@@ -43,19 +47,16 @@
 #define TIMER_4A_INTERRUPT_NUM                  TIMER4A_IRQn
 
 // Timer 5 defines
-#define TIMER_5A_PERIOD                         119999      // Period: 1ms @ 120MHz
+#define TIMER_5A_PERIOD                         119999      // Initial load: 1ms @ 120MHz (reloaded per event)
 #define TIMER_5A_RELOAD_VALUE                   (TIMER_5A_PERIOD << NVIC_ST_RELOAD_S)
 #define TIMER_5A_INTERRUPT_NUM                  TIMER5A_IRQn
 
 // Timer 6 defines
-#define TIMER_6A_PERIOD                         59999999    // Period: 0.5s @ 120MHz
+#define TIMER_6A_PERIOD                         119447      // Period: ~1ms @ 120MHz, not a multiple of the others
 #define TIMER_6A_RELOAD_VALUE                   (TIMER_6A_PERIOD << NVIC_ST_RELOAD_S)
 #define TIMER_6A_INTERRUPT_NUM                  TIMER6A_IRQn
 
-// Timer 7 defines
-#define TIMER_7C_PERIOD                         599999999   // Period: 5s @ 120MHz
-#define TIMER_7C_RELOAD_VALUE                   (TIMER_7C_PERIOD << NVIC_ST_RELOAD_S)
-#define TIMER_7C_INTERRUPT_NUM                  TIMER7A_IRQn
+// Timer 7 is free (the communication timeout is a software timer, see swtimer.h)
 
 // Function definitions
 void clock_sys_init(void);
@@ -64,9 +65,8 @@ void clock_timer1a_init(void);                       // Y Stepper
 void clock_timer2a_init(void);                       // Z Stepper
 void clock_timer3a_init(void);                       // Switches
 void clock_timer4a_init(void);                       // Gantry
-void clock_timer5a_init(void);                       // Delay
-void clock_timer6a_init(void);                       // LED
-void clock_timer7c_init(void);                       // Communication Timeout
+void clock_timer5a_init(void);                       // Software timers
+void clock_timer6a_init(void);                       // PC sampling profiler
 
 void clock_clear_interrupt(TIMER0_Type* timer);
 void clock_stop_timer(TIMER0_Type* timer);
@@ -9,6 +9,7 @@
  */
 
 #include "command_queue.h"
+#include "memstats.h"
 
 static command_t* queue[COMMAND_QUEUE_SIZE];
 static uint16_t head;
@@ -24,16 +25,23 @@ void command_queue_init(void)
 }
 
 /**
- * @brief Pushes an element into the queue. If the queue is full, this will do nothing
+ * @brief Pushes an element into the queue, which then owns it. If the queue is full, the command is freed
  * 
- * @param value The value to be put on the queue
+ * @param value The value to be put on the queue (a failed build, 0, is ignored)
  * @return Whether the push was successful
  */
 bool command_queue_push(command_t* value)
 {
-    // If the queue is full, return
+    // A command that could not be allocated is skipped
+    if (value == NULL)
+    {
+        return false;
+    }
+
+    // If the queue is full, drop the command (nothing else holds it)
     if (command_queue_get_size() == COMMAND_QUEUE_SIZE)
     {
+        memstats_free(value);
         return false;
     }
     else
@@ -124,7 +132,7 @@ bool command_queue_clear(void)
     // Free all remaining commands
     while (command_queue_pop(&p_command))
     {
-        free(p_command);
+        memstats_free(p_command);
     }
 
     return true;
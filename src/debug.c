@@ -0,0 +1,193 @@
+/**
+ * @file debug.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Single-key debug commands answered over a spare UART
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "debug.h"
+#include "isrprofile.h"
+#include "metrics.h"
+#include "pcsample.h"
+#include "replay.h"
+#include "trace.h"
+#include <stdio.h>
+
+// Private functions
+static void debug_rx_handler(uint8_t byte);
+static uint8_t debug_write_help(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+// Commands, in the order '?' lists them
+static const debug_command_t debug_commands[] = {
+    {'?', "List the commands",                   0,                   &debug_write_help},
+    {'m', "Send the game metrics (binary)",      0,                   &metrics_write_frame},
+#ifdef ISR_PROFILING
+    {'i', "Report the ISR cycle profile",        0,                   &isrprofile_write_report},
+    {'I', "Clear the ISR cycle profile",         &isrprofile_reset,   0},
+#endif
+#ifdef COMMAND_TRACING
+    {'t', "Dump the command trace (binary)",     &trace_dump_start,   &trace_write_dump},
+    {'T', "Clear the command trace",             &trace_clear,        0},
+#endif
+#ifdef REPLAY_MODE
+    {'r', "Report the replay timings (CSV)",     0,                   &replay_write_report},
+    {'L', "Load replay moves (L e2e4_ ...)",     0,                   &replay_write_load,       &replay_load_moves},
+    {'g', "Start the replay once it is done",    &replay_start,       0},
+#endif
+#ifdef PC_SAMPLING
+    {'p', "Send the PC samples (binary)",        0,                   &pcsample_write_dump},
+    {'P', "Pause/resume PC sampling",            &pcsample_toggle,    0},
+#endif
+};
+#define NUMBER_OF_DEBUG_COMMANDS            (sizeof(debug_commands) / sizeof(debug_commands[0]))
+
+// Declare the port state
+static volatile uint8_t pending_key           = DEBUG_NO_KEY;   // Written by the Rx ISR only while 0
+static char line[DEBUG_LINE_MAX];                               // Rest of the pending key's line
+static volatile uint8_t line_length           = 0;
+static volatile bool line_done                = false;          // Set by the Rx ISR at the line ending
+static const debug_command_t* p_active        = 0;
+static uint16_t record_index                  = 0;
+static uint8_t record[DEBUG_RECORD_MAX];
+static uint8_t record_length                  = 0;              // Record held until it fits (0 if none)
+
+/**
+ * @brief Initializes the debug port
+ */
+void debug_init(void)
+{
+    uart_set_rx_handler(DEBUG_CHANNEL, &debug_rx_handler);
+    uart_init(DEBUG_CHANNEL);
+}
+
+/**
+ * @brief Starts a command once its key arrives, and sends the next record of the active reply
+ *        (called from the main loop)
+ */
+void debug_service(void)
+{
+    uint8_t i = 0;
+
+    // Look up a newly received key
+    if ((!p_active) && (pending_key != DEBUG_NO_KEY))
+    {
+        for (i = 0; i < NUMBER_OF_DEBUG_COMMANDS; i++)
+        {
+            if (debug_commands[i].key == (char) pending_key)
+            {
+                // A line reader waits until the whole line is in
+                if (debug_commands[i].p_read)
+                {
+                    if (!line_done)
+                    {
+                        return;
+                    }
+                    debug_commands[i].p_read(line, line_length);
+                }
+
+                p_active = &debug_commands[i];
+                record_index = 0;
+                record_length = 0;
+                if (p_active->p_start)
+                {
+                    p_active->p_start();
+                }
+                break;
+            }
+        }
+        pending_key = DEBUG_NO_KEY;
+
+        // Commands without a reply are done
+        if ((p_active) && (!p_active->p_write))
+        {
+            p_active = 0;
+        }
+    }
+
+    if (!p_active)
+    {
+        return;
+    }
+
+    // Build the next record, unless the last one is still waiting for room
+    if (record_length == 0)
+    {
+        record_length = p_active->p_write(record_index, record, DEBUG_RECORD_MAX);
+        if (record_length == 0)
+        {
+            p_active = 0;
+            return;
+        }
+    }
+
+    // Queue the whole record, or retry next time
+    if (uart_out_bytes(DEBUG_CHANNEL, record, record_length))
+    {
+        record_index++;
+        record_length = 0;
+    }
+}
+
+/**
+ * @brief Stores a received key, then the rest of its line (called from the UART Rx ISR)
+ *
+ * @param byte The received byte
+ */
+static void debug_rx_handler(uint8_t byte)
+{
+    bool line_end = ((byte == '\r') || (byte == '\n'));
+
+    // A new key starts a new line (line endings from terminals are not keys)
+    if (pending_key == DEBUG_NO_KEY)
+    {
+        if (!line_end)
+        {
+            line_length = 0;
+            line_done   = false;
+            pending_key = byte;
+        }
+    }
+    // Otherwise, keep the rest of the line until it ends (extra bytes are dropped)
+    else if (!line_done)
+    {
+        if (line_end)
+        {
+            line_done = true;
+        }
+        else if (line_length < DEBUG_LINE_MAX)
+        {
+            line[line_length++] = byte;
+        }
+    }
+}
+
+/**
+ * @brief Writes one line per command (the '?' writer)
+ *
+ * @param index Line number
+ * @param p_buffer Storage for the line
+ * @param size Size of the buffer
+ * @return The line length (0 once every command is listed)
+ */
+static uint8_t debug_write_help(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    int length = 0;
+
+    if (index >= NUMBER_OF_DEBUG_COMMANDS)
+    {
+        return 0;
+    }
+
+    length = snprintf((char*) p_buffer, size, "%c  %s\r\n", debug_commands[index].key,
+                      debug_commands[index].p_description);
+    if (length >= size)
+    {
+        length = size - 1;
+    }
+    return (length > 0) ? (uint8_t) length : 0;
+}
+
+/* End debug.c */
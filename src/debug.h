@@ -0,0 +1,67 @@
+/**
+ * @file debug.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Single-key debug commands answered over a spare UART
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef DEBUG_H_
+#define DEBUG_H_
+
+// Note on the debug port (enabled with DEBUG_PORT in utils.h):
+//  - Each command is a single key sent to DEBUG_CHANNEL ('?' lists them). Keys that arrive while a report
+//      is still being sent are dropped
+//  - A command may run a start function (e.g., clear statistics), then its writer produces the reply
+//      one record at a time, until it returns 0
+//  - A command with a line reader takes the rest of its line as an argument (e.g., "L e2e4_ e7e5_"). The Rx
+//      ISR collects up to DEBUG_LINE_MAX bytes after the key until '\r' or '\n', and the reader runs before
+//      the start function. Other commands ignore the rest of their line
+//  - debug_service() runs in the main loop (DEBUG_SERVICE(), between command actions), so formatting and
+//      snapshots never delay a handler. It builds at most one record per call and only queues it once the
+//      whole record fits in the Tx FIFO, so a report never blocks a command and records never interleave
+//  - DEBUG_CHANNEL is the user channel, so DEBUG_PORT cannot be used with THREE_PARTY_MODE
+//  - To add a command, add a line to debug_commands[] in debug.c
+
+#include "msp.h"
+#include "uart.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General debug port defines
+#define DEBUG_CHANNEL                       (UART_CHANNEL_0)
+#define DEBUG_RECORD_MAX                    (UART_FIFO_SIZE - 4)    // Longest record a writer may produce
+#define DEBUG_NO_KEY                        (0x00)
+#define DEBUG_LINE_MAX                      (96)        // Longest argument line (longer lines are cut)
+
+#if defined(DEBUG_PORT) && (defined(THREE_PARTY_MODE) || defined(USER_MODE))
+#error "DEBUG_PORT needs UART0, which THREE_PARTY_MODE/USER_MODE already use"
+#endif
+
+// Main loop hook
+#ifdef DEBUG_PORT
+#define DEBUG_SERVICE()                     debug_service()
+#else
+#define DEBUG_SERVICE()
+#endif
+
+// Writer type: stores record number index in p_buffer, returns its length (0 when there are no more)
+typedef uint8_t (*debug_writer_t)(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+// Debug command
+typedef struct debug_command_t {
+    char key;
+    const char* p_description;                      // Shown by '?'
+    void (*p_start)(void);                          // Called once when the key arrives (0 if none)
+    debug_writer_t p_write;                         // Produces the reply (0 if none)
+    void (*p_read)(const char* p_line, uint8_t length);    // Takes the rest of the line (0 if none)
+} debug_command_t;
+
+// Public functions
+void debug_init(void);
+void debug_service(void);
+
+#endif /* DEBUG_H_ */
@@ -9,9 +9,11 @@
  */
 
 #include "delay.h"
+#include "metrics.h"
+
+// Private functions
+static void delay_expire(void* p_context);
 
-// Busy wait counter
-static uint32_t count;
 
 /**
  * @brief Dynamically allocates a delay command
@@ -22,16 +24,22 @@ static uint32_t count;
 delay_command_t* delay_build_command(uint16_t time_ms)
 {
     // The thing to return
-    delay_command_t* p_command = (delay_command_t*) malloc(sizeof(delay_command_t));
+    delay_command_t* p_command = (delay_command_t*) memstats_malloc(sizeof(delay_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &delay_entry;
     p_command->command.p_action  = &utils_empty_function;
-    p_command->command.p_exit    = &utils_empty_function;
+    p_command->command.p_exit    = &delay_exit;
     p_command->command.p_is_done = &delay_is_done;
 
     // Data
     p_command->time_ms = time_ms;
+    p_command->expired = false;
+    swtimer_setup(&p_command->timer, &delay_expire, p_command);
 
     return p_command;
 }
@@ -45,12 +53,24 @@ void delay_entry(command_t* command)
 {
     delay_command_t* p_delay_command = (delay_command_t*) command;
 
-    // Interrupts execute every 1ms
-    count = p_delay_command->time_ms;
+    // One interrupt, at this command's own deadline
+    p_delay_command->expired = false;
+    swtimer_arm(&p_delay_command->timer, p_delay_command->time_ms * 1000, 0);
+    metrics_motion_begin(METRICS_DWELL);
+}
+
+/**
+ * @brief Cancels the deadline, in case the delay was cut short (e.g., by a reset)
+ *
+ * @param command A delay command from the command queue
+ */
+void delay_exit(command_t* command)
+{
+    delay_command_t* p_delay_command = (delay_command_t*) command;
 
-    // Enable the timer
-    clock_set_timer_period(DELAY_TIMER, DELAY_PERIOD);
-    clock_start_timer(DELAY_TIMER);
+    // The command is freed next, so its timer must be off the wheel
+    swtimer_cancel(&p_delay_command->timer);
+    metrics_motion_end();
 }
 
 /**
@@ -61,23 +81,21 @@ void delay_entry(command_t* command)
  */
 bool delay_is_done(command_t* command)
 {
-    return (count == 0);
+    delay_command_t* p_delay_command = (delay_command_t*) command;
+
+    return p_delay_command->expired;
 }
 
 /**
- * @brief Decrements a counter to effectivly do a busy wait
+ * @brief Software timer callback marking a delay as over (runs in the software timer interrupt)
+ *
+ * @param p_context The delay command
  */
-__interrupt void DELAY_HANDLER(void)
+static void delay_expire(void* p_context)
 {
-    // Clear the interrupt flag
-    clock_clear_interrupt(DELAY_TIMER);
+    delay_command_t* p_delay_command = (delay_command_t*) p_context;
 
-    // Decrement the counter until it reaches 0
-    count--;
-    if (count == 0)
-    {
-        clock_stop_timer(DELAY_TIMER);
-    }
+    p_delay_command->expired = true;
 }
 
 /* End delay.c */
@@ -11,28 +11,31 @@
 #ifndef DELAY_H_
 #define DELAY_H_
 
+// Note on delays:
+//  - Each delay arms a one-shot software timer for its deadline, so a delay costs one interrupt however long it is
+//  - The timer lives in the command, so several delays can be pending at once (e.g., commands run side by side)
+
 #include "msp.h"
 #include "clock.h"
 #include "command_queue.h"
+#include "swtimer.h"
 #include "utils.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
-// General delay macros
-#define DELAY_TIMER                     (TIMER5)
-#define DELAY_HANDLER                   (TIMER5A_IRQHandler)
-#define DELAY_PERIOD                    (119999)
-
 // Delay command struct
 typedef struct delay_command_t {
     command_t command;
     uint32_t time_ms;
+    swtimer_t timer;                    // Each delay has its own deadline, so any number may be pending
+    volatile bool expired;
 } delay_command_t;
 
 // Command functions
 delay_command_t* delay_build_command(uint16_t time_ms);
 void delay_entry(command_t* command);
+void delay_exit(command_t* command);
 bool delay_is_done(command_t* command);
 
 #endif /* DELAY_H_ */
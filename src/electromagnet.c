@@ -65,7 +65,11 @@ void electromagnet_disengage(void)
 electromagnet_command_t* electromagnet_build_command(peripheral_state_t desired_state)
 {
     // The thing to return
-    electromagnet_command_t* p_command = (electromagnet_command_t*) malloc(sizeof(electromagnet_command_t));
+    electromagnet_command_t* p_command = (electromagnet_command_t*) memstats_malloc(sizeof(electromagnet_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &electromagnet_entry;
@@ -4,27 +4,40 @@
  * @brief Implements First In First Out (FIFO) data structures
  * @version 0.1
  * @date 2022-10-03
- * 
+ *
  * @copyright Copyright (c) 2022
- * 
+ *
  */
 
 #include "fifo.h"
 
 /**
  * @brief Initializes a FIFO (starts empty)
- * 
+ *
  * @param p_fifo Pointer to the specified fifo
+ * @param p_buffer Storage for the elements, at least capacity long
+ * @param capacity Number of elements the FIFO holds. Must be a power of two, at most FIFO8_MAX_SIZE
+ * @return Whether the capacity was valid
  */
-void fifo8_init(fifo8_t* p_fifo)
+bool fifo8_init(fifo8_t* p_fifo, FIFO8_TYPE* p_buffer, uint16_t capacity)
 {
+    // A power of two has a single bit set
+    if ((capacity == 0) || (capacity > FIFO8_MAX_SIZE) || ((capacity & (capacity - 1)) != 0))
+    {
+        return false;
+    }
+
+    p_fifo->fifo = p_buffer;
+    p_fifo->mask = capacity - 1;
     p_fifo->head = 0;
     p_fifo->tail = 0;
+
+    return true;
 }
 
 /**
  * @brief Pushes an element into the FIFO. If the FIFO is full, this will do nothing
- * 
+ *
  * @param p_fifo Pointer to the specified fifo
  * @param value The value to be put on the queue
  * @return Whether the push was successful
@@ -32,30 +45,22 @@ void fifo8_init(fifo8_t* p_fifo)
 bool fifo8_push(fifo8_t* p_fifo, FIFO8_TYPE value)
 {
     // If the FIFO is full, return false
-    if (fifo8_get_size(p_fifo) == FIFO8_SIZE)
+    if (fifo8_is_full(p_fifo))
     {
         return false;
     }
-    else
-    {
-        // Put the value in
-        p_fifo->fifo[p_fifo->head] = value;
-
-        // Advance the head
-        p_fifo->head += 1;
-        if (p_fifo->head >= FIFO8_SIZE)
-        {
-            p_fifo->head = 0;
-        }
-
-        // Success
-        return true;
-    }
+
+    // Put the value in, then advance the head
+    p_fifo->fifo[p_fifo->head & p_fifo->mask] = value;
+    p_fifo->head++;
+
+    // Success
+    return true;
 }
 
 /**
- * @brief Removes the value at the front of the FIFO. If there is nothing in the FIFO, the storage pointer is evaulated to NULL
- * 
+ * @brief Removes the value at the front of the FIFO. If there is nothing in the FIFO, nothing is stored
+ *
  * @param p_fifo Pointer to the specified fifo
  * @param p_value Pointer to where the value will be stored
  * @return Whether the pop was successful
@@ -67,45 +72,196 @@ bool fifo8_pop(fifo8_t* p_fifo, FIFO8_TYPE* p_value)
     {
         return false;
     }
-    else 
+
+    // Get the value, then advance the tail
+    *p_value = p_fifo->fifo[p_fifo->tail & p_fifo->mask];
+    p_fifo->tail++;
+
+    // Success
+    return true;
+}
+
+/**
+ * @brief Reads the value at the front of the FIFO without removing it
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param p_value Pointer to where the value will be stored
+ * @return Whether there was a value to read
+ */
+bool fifo8_peek(fifo8_t* p_fifo, FIFO8_TYPE* p_value)
+{
+    if (fifo8_is_empty(p_fifo))
     {
-        // Get the value
-        *p_value = p_fifo->fifo[p_fifo->tail];
-
-        // Advance the tail
-        p_fifo->tail += 1;
-        if (p_fifo->tail >= FIFO8_SIZE)
-        {
-            p_fifo->tail = 0;
-        }
-        
-        // Success
-        return true;
+        return false;
     }
+
+    *p_value = p_fifo->fifo[p_fifo->tail & p_fifo->mask];
+    return true;
 }
 
 /**
- * @brief Gives the number of elements currently in the FIFO
- * 
+ * @brief Pushes as many of the given elements as fit
+ *
  * @param p_fifo Pointer to the specified fifo
- * @return The size of the specified fifo
+ * @param p_values The values to be put on the queue
+ * @param count Number of values
+ * @return The number of values pushed
  */
-uint16_t fifo8_get_size(fifo8_t* p_fifo)
+uint16_t fifo8_push_n(fifo8_t* p_fifo, const FIFO8_TYPE* p_values, uint16_t count)
 {
-    // When (head==tail), the size is 0
-    if (p_fifo->head >= p_fifo->tail) 
+    uint16_t free_slots = fifo8_get_free(p_fifo);
+    if (count > free_slots)
     {
-        return p_fifo->head - p_fifo->tail;
+        count = free_slots;
     }
-    else 
+
+    // Copy everything in before publishing the new head
+    uint16_t head = p_fifo->head;
+    uint16_t i = 0;
+    for (i = 0; i < count; i++)
     {
-        return FIFO8_SIZE - (p_fifo->tail - p_fifo->head) + 1;
+        p_fifo->fifo[(head + i) & p_fifo->mask] = p_values[i];
     }
+    p_fifo->head = head + count;
+
+    return count;
+}
+
+/**
+ * @brief Removes up to count elements from the front of the FIFO
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param p_values Storage for the values
+ * @param count Maximum number of values to remove
+ * @return The number of values removed
+ */
+uint16_t fifo8_pop_n(fifo8_t* p_fifo, FIFO8_TYPE* p_values, uint16_t count)
+{
+    count = fifo8_peek_n(p_fifo, p_values, count);
+    p_fifo->tail += count;
+
+    return count;
+}
+
+/**
+ * @brief Reads up to count elements from the front of the FIFO without removing them
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param p_values Storage for the values
+ * @param count Maximum number of values to read
+ * @return The number of values read
+ */
+uint16_t fifo8_peek_n(fifo8_t* p_fifo, FIFO8_TYPE* p_values, uint16_t count)
+{
+    uint16_t size = fifo8_get_size(p_fifo);
+    if (count > size)
+    {
+        count = size;
+    }
+
+    uint16_t tail = p_fifo->tail;
+    uint16_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        p_values[i] = p_fifo->fifo[(tail + i) & p_fifo->mask];
+    }
+
+    return count;
+}
+
+/**
+ * @brief Gets the contiguous run of elements at the front of the FIFO. Follow with fifo8_commit_read()
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param pp_values Set to the first element of the run
+ * @return The number of elements in the run (0 if the FIFO is empty)
+ */
+uint16_t fifo8_get_read_span(fifo8_t* p_fifo, FIFO8_TYPE** pp_values)
+{
+    uint16_t start = p_fifo->tail & p_fifo->mask;
+    uint16_t to_end = fifo8_get_capacity(p_fifo) - start;
+    uint16_t size = fifo8_get_size(p_fifo);
+
+    *pp_values = &p_fifo->fifo[start];
+    return (size < to_end) ? size : to_end;
+}
+
+/**
+ * @brief Removes elements read through a read span
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param count Number of elements consumed, at most the span length
+ */
+void fifo8_commit_read(fifo8_t* p_fifo, uint16_t count)
+{
+    p_fifo->tail += count;
+}
+
+/**
+ * @brief Gets the contiguous run of free slots at the back of the FIFO. Follow with fifo8_commit_write()
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param pp_values Set to the first free slot of the run
+ * @return The number of free slots in the run (0 if the FIFO is full)
+ */
+uint16_t fifo8_get_write_span(fifo8_t* p_fifo, FIFO8_TYPE** pp_values)
+{
+    uint16_t start = p_fifo->head & p_fifo->mask;
+    uint16_t to_end = fifo8_get_capacity(p_fifo) - start;
+    uint16_t free_slots = fifo8_get_free(p_fifo);
+
+    *pp_values = &p_fifo->fifo[start];
+    return (free_slots < to_end) ? free_slots : to_end;
+}
+
+/**
+ * @brief Publishes elements written through a write span
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @param count Number of elements written, at most the span length
+ */
+void fifo8_commit_write(fifo8_t* p_fifo, uint16_t count)
+{
+    p_fifo->head += count;
+}
+
+/**
+ * @brief Gives the number of elements currently in the FIFO
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @return The size of the specified fifo
+ */
+uint16_t fifo8_get_size(fifo8_t* p_fifo)
+{
+    // The counters wrap together, so the difference is the size even across a wrap
+    return (uint16_t) (p_fifo->head - p_fifo->tail);
+}
+
+/**
+ * @brief Gives the number of elements the FIFO can hold
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @return The capacity of the specified fifo
+ */
+uint16_t fifo8_get_capacity(fifo8_t* p_fifo)
+{
+    return p_fifo->mask + 1;
+}
+
+/**
+ * @brief Gives the number of elements that can still be pushed
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @return The free space of the specified fifo
+ */
+uint16_t fifo8_get_free(fifo8_t* p_fifo)
+{
+    return fifo8_get_capacity(p_fifo) - fifo8_get_size(p_fifo);
 }
 
 /**
  * @brief Checks if the FIFO is empty or not
- * 
+ *
  * @param p_fifo Pointer to the specified fifo
  * @return True if the FIFO is empty, false otherwise
  */
@@ -115,14 +271,25 @@ bool fifo8_is_empty(fifo8_t* p_fifo)
 }
 
 /**
- * @brief Clears the FIFO
- * 
+ * @brief Checks if the FIFO is full or not
+ *
+ * @param p_fifo Pointer to the specified fifo
+ * @return True if the FIFO is full, false otherwise
+ */
+bool fifo8_is_full(fifo8_t* p_fifo)
+{
+    return fifo8_get_size(p_fifo) > p_fifo->mask;
+}
+
+/**
+ * @brief Clears the FIFO (discards everything not yet popped)
+ *
  * @param p_fifo Pointer to the specified fifo
  * @return True always
  */
 bool fifo8_clear(fifo8_t* p_fifo)
 {
-    p_fifo->head = p_fifo->tail;
+    p_fifo->tail = p_fifo->head;
     return true;
 }
 
@@ -11,25 +11,48 @@
 #ifndef FIFO_H_
 #define FIFO_H_
 
+// Note on fifo8:
+//  - Each FIFO is a ring over a buffer supplied at initialization, so capacities can differ per instance
+//  - Capacities must be powers of two, so wrapping is a mask instead of a compare
+//  - head and tail count pushes and pops freely (wrapping at 65536), so size is just (head - tail) and
+//      every slot of the buffer is usable
+//  - One context may push while another pops (e.g., main loop and ISR) without locking. Bulk and span
+//      functions keep the same rule: writers only move head, readers only move tail
+//  - Spans give direct access to the contiguous part of the buffer, so data can be moved without an
+//      intermediate copy. A span ends at the end of the buffer, so a wrapped region takes two spans
+
 #include <stdint.h>
 #include <stdbool.h>
 
 #define FIFO8_TYPE              uint8_t
-#define FIFO8_SIZE              (64)        // Must be at  least 1 and less than 65535
+#define FIFO8_SIZE              (64)        // Default capacity. Must be a power of two, at most 32768
+#define FIFO8_MAX_SIZE          (32768)
 
 // Fifo data structure
 typedef struct fifo8_t {
-    FIFO8_TYPE fifo[FIFO8_SIZE];
-    uint16_t head;
-    uint16_t tail;
+    FIFO8_TYPE* fifo;
+    uint16_t mask;                          // Capacity - 1
+    volatile uint16_t head;                 // Total pushes
+    volatile uint16_t tail;                 // Total pops
 } fifo8_t;
 
 // Public functions for 8-bit FIFO
-void fifo8_init(fifo8_t* fifo);
+bool fifo8_init(fifo8_t* fifo, FIFO8_TYPE* buffer, uint16_t capacity);
 bool fifo8_push(fifo8_t* fifo, FIFO8_TYPE value);
 bool fifo8_pop(fifo8_t* fifo, FIFO8_TYPE* p_value);
+bool fifo8_peek(fifo8_t* fifo, FIFO8_TYPE* p_value);
+uint16_t fifo8_push_n(fifo8_t* fifo, const FIFO8_TYPE* values, uint16_t count);
+uint16_t fifo8_pop_n(fifo8_t* fifo, FIFO8_TYPE* values, uint16_t count);
+uint16_t fifo8_peek_n(fifo8_t* fifo, FIFO8_TYPE* values, uint16_t count);
+uint16_t fifo8_get_read_span(fifo8_t* fifo, FIFO8_TYPE** pp_values);
+void fifo8_commit_read(fifo8_t* fifo, uint16_t count);
+uint16_t fifo8_get_write_span(fifo8_t* fifo, FIFO8_TYPE** pp_values);
+void fifo8_commit_write(fifo8_t* fifo, uint16_t count);
 uint16_t fifo8_get_size(fifo8_t* fifo);
+uint16_t fifo8_get_capacity(fifo8_t* fifo);
+uint16_t fifo8_get_free(fifo8_t* fifo);
 bool fifo8_is_empty(fifo8_t* fifo);
+bool fifo8_is_full(fifo8_t* fifo);
 bool fifo8_clear(fifo8_t* fifo);
 
 #endif /* FIFO_H_ */
@@ -0,0 +1,332 @@
+/**
+ * @file frame.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Incremental decoder for framed UART messages
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "frame.h"
+
+// Private functions
+static void frame_parser_sum(frame_parser_t* p_parser, uint8_t byte);
+static void frame_parser_check_bytes(frame_parser_t* p_parser, uint8_t check_bytes[2]);
+static void frame_parser_post(frame_parser_t* p_parser);
+
+/**
+ * @brief Initialize a parser (starts waiting for a START byte, with an empty queue)
+ *
+ * @param p_parser The parser
+ */
+void frame_parser_init(frame_parser_t* p_parser)
+{
+    p_parser->state           = FRAME_WAIT_START;
+    p_parser->index           = 0;
+    p_parser->sum1            = 0;
+    p_parser->sum2            = 0;
+    p_parser->check_byte_0    = 0;
+    p_parser->cobs_remaining  = 0;
+    p_parser->cobs_code       = 0;
+    p_parser->head            = 0;
+    p_parser->tail            = 0;
+    p_parser->acks_received   = 0;
+    p_parser->acks_taken      = 0;
+    p_parser->frames_received = 0;
+    p_parser->check_errors    = 0;
+    p_parser->frames_dropped  = 0;
+    p_parser->resyncs         = 0;
+}
+
+/**
+ * @brief Discards any partial frame, queued frames, and untaken ACKs. Statistics are kept
+ *
+ * @param p_parser The parser
+ */
+void frame_parser_reset(frame_parser_t* p_parser)
+{
+    p_parser->state          = FRAME_WAIT_START;
+    p_parser->cobs_code      = 0;
+    p_parser->cobs_remaining = 0;
+    p_parser->tail           = p_parser->head;
+    p_parser->acks_taken     = p_parser->acks_received;
+}
+
+/**
+ * @brief Discards any partial frame, keeping the frames and ACKs already validated (e.g., around a baud rate change)
+ *
+ * @param p_parser The parser
+ */
+void frame_parser_resync(frame_parser_t* p_parser)
+{
+    p_parser->state          = FRAME_WAIT_START;
+    p_parser->cobs_code      = 0;
+    p_parser->cobs_remaining = 0;
+}
+
+/**
+ * @brief Helper function to add a byte to the running Fletcher-16 sums (same math as utils_fl16_data_to_checksum())
+ *
+ * @param p_parser The parser
+ * @param byte The byte to add
+ */
+static void frame_parser_sum(frame_parser_t* p_parser, uint8_t byte)
+{
+    // Conditional subtractiton is more efficient than a modulus operation
+    p_parser->sum1 += byte;
+    if (p_parser->sum1 > 255)
+    {
+        p_parser->sum1 -= 255;
+    }
+
+    p_parser->sum2 += p_parser->sum1;
+    if (p_parser->sum2 > 255)
+    {
+        p_parser->sum2 -= 255;
+    }
+}
+
+/**
+ * @brief Helper function to turn the running sums into check bytes (same math as utils_fl16_checksum_to_checkbytes()).
+ *        Kept here so the parser only depends on frame.h and builds on a host (see tools/frame_bench.c)
+ *
+ * @param p_parser The parser
+ * @param check_bytes The expected check bytes
+ */
+static void frame_parser_check_bytes(frame_parser_t* p_parser, uint8_t check_bytes[2])
+{
+    uint16_t c0 = (0xFF - ((p_parser->sum1 + p_parser->sum2) % 0xFF));
+    uint16_t c1 = (0xFF - ((p_parser->sum1 + c0) % 0xFF));
+
+    check_bytes[0] = c0;
+    check_bytes[1] = c1;
+}
+
+/**
+ * @brief Helper function to queue the assembled frame
+ *
+ * @param p_parser The parser
+ */
+static void frame_parser_post(frame_parser_t* p_parser)
+{
+    uint8_t next_head = (p_parser->head + 1) % FRAME_QUEUE_SIZE;
+
+    // If the queue is full, drop the frame
+    if (next_head == p_parser->tail)
+    {
+        p_parser->frames_dropped++;
+        return;
+    }
+
+    p_parser->queue[p_parser->head] = p_parser->frame;
+    p_parser->head = next_head;
+    p_parser->frames_received++;
+}
+
+/**
+ * @brief Advances the parser by one received byte. Called from the UART Rx ISR
+ *
+ * @param p_parser The parser
+ * @param byte The received byte
+ */
+void frame_parser_feed(frame_parser_t* p_parser, uint8_t byte)
+{
+    uint8_t check_bytes[2];
+
+    switch (p_parser->state)
+    {
+        case FRAME_WAIT_START:
+            if ((byte == START_BYTE) || (byte == START_BYTE_V2))
+            {
+                p_parser->sum1  = 0;
+                p_parser->sum2  = 0;
+                p_parser->index = 0;
+                p_parser->frame.version = (byte == START_BYTE) ? 1 : 2;
+                p_parser->frame.seq     = 0;
+                p_parser->frame.ack     = 0;
+                frame_parser_sum(p_parser, byte);
+                p_parser->state = FRAME_WAIT_INSTR;
+            }
+            else if (byte == ACK_BYTE)
+            {
+                p_parser->acks_received++;
+            }
+        break;
+
+        case FRAME_WAIT_INSTR:
+            frame_parser_sum(p_parser, byte);
+            p_parser->frame.instruction = FRAME_INSTR(byte);
+            p_parser->frame.length      = FRAME_LENGTH(byte);
+            if (p_parser->frame.version >= 2)
+            {
+                p_parser->state = FRAME_WAIT_SEQ;
+            }
+            else
+            {
+                p_parser->state = (p_parser->frame.length > 0) ? FRAME_OPERANDS : FRAME_CHECK_0;
+            }
+        break;
+
+        case FRAME_WAIT_SEQ:
+            frame_parser_sum(p_parser, byte);
+            p_parser->frame.seq = FRAME_SEQ(byte);
+            p_parser->frame.ack = FRAME_ACK(byte);
+            p_parser->state = (p_parser->frame.length > 0) ? FRAME_OPERANDS : FRAME_CHECK_0;
+        break;
+
+        case FRAME_OPERANDS:
+            frame_parser_sum(p_parser, byte);
+            p_parser->frame.operands[p_parser->index++] = byte;
+            if (p_parser->index >= p_parser->frame.length)
+            {
+                p_parser->state = FRAME_CHECK_0;
+            }
+        break;
+
+        case FRAME_CHECK_0:
+            p_parser->check_byte_0 = byte;
+            p_parser->state = FRAME_CHECK_1;
+        break;
+
+        case FRAME_CHECK_1:
+            // Compare against the check bytes of the running sums
+            frame_parser_check_bytes(p_parser, check_bytes);
+            if ((check_bytes[0] == p_parser->check_byte_0) && (check_bytes[1] == byte))
+            {
+                frame_parser_post(p_parser);
+            }
+            else
+            {
+                p_parser->check_errors++;
+            }
+            p_parser->state = FRAME_WAIT_START;
+        break;
+
+        default:
+            p_parser->state = FRAME_WAIT_START;
+        break;
+    }
+}
+
+/**
+ * @brief Advances the parser by one received COBS-encoded byte. Called from the UART Rx ISR
+ *
+ * @param p_parser The parser
+ * @param byte The received byte
+ */
+void frame_parser_feed_cobs(frame_parser_t* p_parser, uint8_t byte)
+{
+    // A delimiter ends the frame, complete or not
+    if (byte == FRAME_COBS_DELIMITER)
+    {
+        if (p_parser->state != FRAME_WAIT_START)
+        {
+            p_parser->resyncs++;
+            p_parser->state = FRAME_WAIT_START;
+        }
+        p_parser->cobs_code      = 0;
+        p_parser->cobs_remaining = 0;
+        return;
+    }
+
+    // Data byte of the current block
+    if (p_parser->cobs_remaining > 0)
+    {
+        p_parser->cobs_remaining--;
+        frame_parser_feed(p_parser, byte);
+        return;
+    }
+
+    // Otherwise, this starts a new block. Every block but the first and those after a full one (0xFF)
+    // stands for a zero that was removed
+    if ((p_parser->cobs_code != 0) && (p_parser->cobs_code != 0xFF))
+    {
+        frame_parser_feed(p_parser, 0x00);
+    }
+    p_parser->cobs_code      = byte;
+    p_parser->cobs_remaining = byte - 1;
+}
+
+/**
+ * @brief Byte-stuffs data with COBS and appends the delimiter
+ *
+ * @param p_data The data
+ * @param length Number of data bytes
+ * @param p_encoded Storage for the encoded data, at least FRAME_COBS_MAX_LENGTH(length) long
+ * @return The number of encoded bytes (including the delimiter)
+ */
+uint16_t frame_cobs_encode(const uint8_t* p_data, uint16_t length, uint8_t* p_encoded)
+{
+    uint16_t code_index = 0;
+    uint16_t out_index  = 1;
+    uint8_t  code       = 1;
+    uint16_t i          = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (p_data[i] == 0x00)
+        {
+            // Close the block, the zero becomes its code
+            p_encoded[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        }
+        else
+        {
+            p_encoded[out_index++] = p_data[i];
+            code++;
+
+            // A full block has no implied zero
+            if (code == 0xFF)
+            {
+                p_encoded[code_index] = code;
+                code_index = out_index++;
+                code = 1;
+            }
+        }
+    }
+
+    p_encoded[code_index]  = code;
+    p_encoded[out_index++] = FRAME_COBS_DELIMITER;
+
+    return out_index;
+}
+
+/**
+ * @brief Takes the oldest validated frame, without blocking
+ *
+ * @param p_parser The parser
+ * @param p_frame Storage for the frame
+ * @return true if a frame was available
+ */
+bool frame_parser_pop(frame_parser_t* p_parser, frame_t* p_frame)
+{
+    if (p_parser->tail == p_parser->head)
+    {
+        return false;
+    }
+
+    *p_frame = p_parser->queue[p_parser->tail];
+    p_parser->tail = (p_parser->tail + 1) % FRAME_QUEUE_SIZE;
+    return true;
+}
+
+/**
+ * @brief Takes one received ACK, without blocking
+ *
+ * @param p_parser The parser
+ * @return true if an ACK was available
+ */
+bool frame_parser_take_ack(frame_parser_t* p_parser)
+{
+    if (p_parser->acks_taken == p_parser->acks_received)
+    {
+        return false;
+    }
+
+    p_parser->acks_taken++;
+    return true;
+}
+
+/* End frame.c */
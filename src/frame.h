@@ -0,0 +1,111 @@
+/**
+ * @file frame.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Incremental decoder for framed UART messages
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef FRAME_H_
+#define FRAME_H_
+
+// Note on the frame parser:
+//  - Bytes are fed one at a time from the UART Rx ISR (see uart_set_rx_handler()), so no command ever
+//      waits on the UART
+//  - The parser steps START -> INSTRUCTION/LENGTH -> (SEQ/ACK) -> OPERANDS -> CHECK BYTES, updating the
+//      Fletcher-16 sums as bytes arrive. Validating a frame only costs a compare once its last check byte lands
+//  - The START byte tags the framing version. Version 2 frames add a SEQ/ACK byte (see raspberrypi.h)
+//  - Valid frames are posted to a small queue. Invalid frames are dropped (the sender retransmits)
+//  - A lone ACK byte between frames is counted, not queued
+//  - The ISR is the only producer and one command at a time is the consumer, so no locking is needed
+
+// Note on COBS framing (enabled with COBS_FRAMING in utils.h):
+//  - START_BYTE can legally appear in operands and check bytes, so after a glitch the raw parser may lock
+//      onto a false start and reject frames until the sender gives up on them
+//  - With COBS, every frame (or lone ACK) is byte-stuffed so it contains no 0x00, and is followed by a
+//      0x00 delimiter. frame_parser_feed_cobs() undoes the stuffing as bytes arrive and feeds the result
+//      to frame_parser_feed(), so the frame layout and checks are unchanged
+//  - Every delimiter returns the parser to FRAME_WAIT_START, so it is back in step by the next frame
+//  - Encoding costs one byte per 254 (plus the delimiter), see FRAME_COBS_MAX_LENGTH()
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Start bytes + ACK signal
+#define START_BYTE                          (0x0A)
+#define START_BYTE_V2                       (0x0B)
+#define ACK_BYTE                            (0x0F)
+
+// General frame defines
+#define FRAME_MAX_OPERANDS                  (15)        // The operand length is a 4-bit field
+#define FRAME_QUEUE_SIZE                    (4)
+#define FRAME_INSTR(instr_and_len)          ((uint8_t) ((instr_and_len) >> 4))
+#define FRAME_LENGTH(instr_and_len)         ((uint8_t) ((instr_and_len) & 0x0F))
+#define FRAME_SEQ(seq_and_ack)              ((uint8_t) ((seq_and_ack) >> 4))
+#define FRAME_ACK(seq_and_ack)              ((uint8_t) ((seq_and_ack) & 0x0F))
+
+// COBS defines
+#define FRAME_COBS_DELIMITER                (0x00)
+#define FRAME_COBS_MAX_LENGTH(length)       ((length) + ((length) / 254) + 2)   // Overhead + delimiter
+
+// Parser states
+typedef enum frame_parser_state_t {
+    FRAME_WAIT_START,
+    FRAME_WAIT_INSTR,
+    FRAME_WAIT_SEQ,
+    FRAME_OPERANDS,
+    FRAME_CHECK_0,
+    FRAME_CHECK_1,
+} frame_parser_state_t;
+
+// A validated frame
+typedef struct frame_t {
+    uint8_t version;                                // 1 or 2, from the START byte
+    uint8_t seq;                                    // Version 2 only: sequence number of this frame
+    uint8_t ack;                                    // Version 2 only: next sequence number the sender expects
+    uint8_t instruction;
+    uint8_t length;                                 // Number of operand bytes
+    uint8_t operands[FRAME_MAX_OPERANDS];
+} frame_t;
+
+// Parser for one UART channel
+typedef struct frame_parser_t {
+    // Decoder state (only touched by the ISR)
+    frame_parser_state_t state;
+    frame_t frame;                                  // Frame being assembled
+    uint8_t index;                                  // Operands received so far
+    uint16_t sum1;                                  // Running Fletcher-16 sums
+    uint16_t sum2;
+    uint8_t check_byte_0;
+    uint8_t cobs_remaining;                         // COBS: data bytes left in the current block
+    uint8_t cobs_code;                              // COBS: code byte of the current block (0 between frames)
+
+    // Frame queue (ISR pushes at head, commands pop at tail)
+    frame_t queue[FRAME_QUEUE_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+
+    // ACKs (ISR counts received, commands count taken)
+    volatile uint32_t acks_received;
+    uint32_t acks_taken;
+
+    // Statistics
+    volatile uint32_t frames_received;
+    volatile uint32_t check_errors;
+    volatile uint32_t frames_dropped;               // Valid, but the queue was full
+    volatile uint32_t resyncs;                      // COBS: frames cut short by a delimiter
+} frame_parser_t;
+
+// Public functions
+void frame_parser_init(frame_parser_t* p_parser);
+void frame_parser_reset(frame_parser_t* p_parser);
+void frame_parser_resync(frame_parser_t* p_parser);
+void frame_parser_feed(frame_parser_t* p_parser, uint8_t byte);
+bool frame_parser_pop(frame_parser_t* p_parser, frame_t* p_frame);
+bool frame_parser_take_ack(frame_parser_t* p_parser);
+void frame_parser_feed_cobs(frame_parser_t* p_parser, uint8_t byte);
+uint16_t frame_cobs_encode(const uint8_t* p_data, uint16_t length, uint8_t* p_encoded);
+
+#endif /* FRAME_H_ */
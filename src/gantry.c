@@ -13,6 +13,9 @@
 // Private functions
 static void gantry_kill(void);
 static void gantry_estop(void);
+static void gantry_switch_edge(uint16_t pressed, uint32_t entry_cycles);
+static void gantry_comm_timeout(void* p_context);
+static void gantry_comm_push(char* message, uint8_t message_length);
 
 // Stores the board readings, which are read in an interrupt and used in various commands
 uint64_t board_reading_current      = 0;
@@ -30,10 +33,19 @@ static bool initial_valid      = false;
 static bool msg_ready_to_send  = true;
 static bool robot_is_done      = false;
 
-#ifdef THREE_PART_MODE
+#ifdef THREE_PARTY_MODE
 static bool ready_to_read      = false;
 #endif
 
+// Communication timeout (re-armed with the link's retransmission timeout on every send)
+static swtimer_t comm_timer;
+
+// Stop latency measurements (core clock cycles)
+static volatile uint32_t edge_timestamp         = 0;
+static volatile bool     edge_pending           = false;
+static volatile uint32_t edge_stop_cycles_max   = 0;
+static volatile uint32_t poll_detect_cycles_max = 0;
+
 /**
  * @brief Initializes all modules
  */
@@ -46,10 +58,11 @@ void gantry_init(void)
     clock_timer2a_init();               // Z
     clock_timer3a_init();               // Switches
     clock_timer4a_init();               // Gantry
-    clock_timer5a_init();               // Delay
-    clock_timer6a_init();               // LEDs
-    clock_timer7c_init();               // Comm delay
+    clock_timer5a_init();               // Software timers (delay, LEDs, comm)
+    timebase_init();
+    swtimer_init();
     clock_start_timer(GANTRY_TIMER);
+    swtimer_setup(&comm_timer, &gantry_comm_timeout, 0);
 
     // System level initialization of all other modules
     command_queue_init();
@@ -61,12 +74,24 @@ void gantry_init(void)
 
 #ifdef PERIPHERALS_ENABLED
     sensornetwork_init();
+    sensorhealth_init();
     electromagnet_init();
+
+    // Tune the sensor settle times, assuming the pieces start set up (retried once the start state is valid)
+    sensornetwork_calibrate(INITIAL_PRESENCE_BOARD, sensorhealth_get_health_bitmap());
 #endif
 
 #ifdef THREE_PARTY_MODE
     uart_init(UART_CHANNEL_0);
 #endif
+
+#ifdef DEBUG_PORT
+    debug_init();
+#endif
+
+#ifdef PC_SAMPLING
+    pcsample_init();
+#endif
 }
 
 /**
@@ -101,6 +126,17 @@ void gantry_home(void)
  */
 static void gantry_kill(void)
 {
+    // Measure how much later the polled path saw what the edge interrupt already handled
+    if (edge_pending)
+    {
+        uint32_t poll_cycles = utils_get_cycles() - edge_timestamp;
+        if (poll_cycles > poll_detect_cycles_max)
+        {
+            poll_detect_cycles_max = poll_cycles;
+        }
+        edge_pending = false;
+    }
+
     // Disable all motors
     stepper_x_stop();
     stepper_y_stop();
@@ -124,6 +160,63 @@ static void gantry_estop(void)
     sys_fault = true;
 }
 
+/**
+ * @brief Stops the motors from a switch edge interrupt. Only the time-critical work happens here,
+ *  the polled path in GANTRY_HANDLER still performs the full kill/E-stop
+ *
+ * @param pressed Switch masks of the closed switches that interrupted
+ * @param entry_cycles Cycle count on entry to the interrupt
+ */
+static void gantry_switch_edge(uint16_t pressed, uint32_t entry_cycles)
+{
+    // Limits are expected while homing, and handled by the stepper module
+    if ((pressed & E_STOP_MASK) || ((pressed & LIMIT_MASK) && (!gantry_homing)))
+    {
+        stepper_x_stop();
+        stepper_y_stop();
+        stepper_z_stop();
+    }
+    else
+    {
+        return;
+    }
+
+    if (pressed & E_STOP_MASK)
+    {
+        sys_fault = true;
+    }
+
+    // Record the interrupt-to-stopped time
+    uint32_t stop_cycles = utils_get_cycles() - entry_cycles;
+    if (stop_cycles > edge_stop_cycles_max)
+    {
+        edge_stop_cycles_max = stop_cycles;
+    }
+    edge_timestamp = entry_cycles;
+    edge_pending   = true;
+}
+
+/**
+ * @brief Gets the longest time the edge interrupts took to stop the motors
+ *
+ * @return The time in core clock cycles (from handler entry, so add ~12 cycles of interrupt latency)
+ */
+uint32_t gantry_get_edge_stop_cycles_max(void)
+{
+    return edge_stop_cycles_max;
+}
+
+/**
+ * @brief Gets the longest delay between an edge interrupt and the polled path seeing the same switch,
+ *  i.e., how much sooner the edge path reacts
+ *
+ * @return The time in core clock cycles
+ */
+uint32_t gantry_get_poll_detect_cycles_max(void)
+{
+    return poll_detect_cycles_max;
+}
+
 /* Command Functions */
 
 /**
@@ -134,7 +227,11 @@ static void gantry_estop(void)
 gantry_command_t* gantry_start_state_build_command(void)
 {
     // The thing to return
-    gantry_command_t* p_command = (gantry_command_t*) malloc(sizeof(gantry_command_t));
+    gantry_command_t* p_command = (gantry_command_t*) memstats_malloc(sizeof(gantry_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_start_state_entry;
@@ -162,8 +259,11 @@ void gantry_start_state_entry(command_t* command)
  */
 void gantry_start_state_action(command_t* command)
 {
-    // Read the board's initial state
-    uint64_t initial_presence = sensornetwork_get_reading();
+    // Read the board's initial state, masking out any squares already known to have dead sensors
+    uint64_t expected_presence = (chessboard_get_previous_white_presence() | chessboard_get_previous_black_presence());
+    uint64_t initial_presence = sensorhealth_get_reading();
+    initial_presence = sensorhealth_mask_reading(initial_presence, expected_presence);
+
     uint64_t initial_presence_white = initial_presence & (chessboard_get_previous_white_presence());
     uint64_t initial_presence_black = initial_presence & (chessboard_get_previous_black_presence());
 
@@ -182,6 +282,12 @@ void gantry_start_state_action(command_t* command)
     {
         initial_valid = true;
         led_mode(LED_HUMAN_MOVE);
+
+        // The board is in a known position, so finish tuning the sensor settle times if boot could not
+        if (!sensornetwork_is_calibrated())
+        {
+            sensornetwork_calibrate(expected_presence, sensorhealth_get_health_bitmap());
+        }
     }
 }
 
@@ -213,7 +319,11 @@ bool gantry_start_state_is_done(command_t* command)
 gantry_command_t* gantry_reset_build_command(void)
 {
     // The thing to return
-    gantry_command_t* p_command = (gantry_command_t*) malloc(sizeof(gantry_command_t));
+    gantry_command_t* p_command = (gantry_command_t*) memstats_malloc(sizeof(gantry_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_reset_entry;
@@ -234,6 +344,9 @@ void gantry_reset_entry(command_t* command)
     // Clear the command queue
     command_queue_clear();
 
+    // Every game gets its own metrics
+    metrics_new_game();
+
     // Indicate that the Pi's not up yet
     led_mode(LED_ROBOT_MOVE);
 
@@ -246,6 +359,9 @@ void gantry_reset_entry(command_t* command)
     // Reset the rpi
     rpi_reset_uart();
 
+    // Move the link off the default rate, if it is not already
+    command_queue_push((command_t*) rpi_baud_build_command(RPI_NEGOTIATED_BAUD_RATE));
+
     // Read the user color
     char user_color = 'W';
 
@@ -270,7 +386,7 @@ void gantry_reset_entry(command_t* command)
 
         char message[START_INSTR_LENGTH];
         rpi_build_start_msg(user_color, message);
-        command_queue_push((command_t*) gantry_comm_build_command(message, START_INSTR_LENGTH));
+        gantry_comm_push(message, START_INSTR_LENGTH);
 
         // After receiving an ACK, goto human command
         command_queue_push((command_t*) gantry_human_build_command());
@@ -280,7 +396,7 @@ void gantry_reset_entry(command_t* command)
 
         char message[START_INSTR_LENGTH];
         rpi_build_start_msg(user_color, message);
-        command_queue_push((command_t*) gantry_comm_build_command(message, START_INSTR_LENGTH));
+        gantry_comm_push(message, START_INSTR_LENGTH);
 
         // After receiving an ACK, goto robot command
         command_queue_push((command_t*) gantry_robot_build_command());
@@ -290,14 +406,14 @@ void gantry_reset_entry(command_t* command)
     }
 
 #elif defined(THREE_PARTY_MODE)
-    uart_reset(USER_CHANNEL);
+    rpi_reset_user_uart();
 
     // User is always white, start in gantry_human
     user_color = 'W';
 
     char message[START_INSTR_LENGTH];
     rpi_build_start_msg(user_color, message);
-    command_queue_push((command_t*) gantry_comm_build_command(message, START_INSTR_LENGTH));
+    gantry_comm_push(message, START_INSTR_LENGTH);
 
     // After receiving an ACK, goto human command
     command_queue_push((command_t*) gantry_human_build_command());
@@ -323,7 +439,11 @@ gantry_command_t* gantry_human_build_command(void)
 {
 #ifdef FINAL_IMPLEMENTATION_MODE
     // The thing to return
-    gantry_command_t* p_command = (gantry_command_t*) malloc(sizeof(gantry_command_t));
+    gantry_command_t* p_command = (gantry_command_t*) memstats_malloc(sizeof(gantry_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_human_entry;
@@ -333,7 +453,11 @@ gantry_command_t* gantry_human_build_command(void)
 
 #elif defined(THREE_PARTY_MODE)
     // The thing to return
-    gantry_robot_command_t* p_command = (gantry_robot_command_t*) malloc(sizeof(gantry_robot_command_t));
+    gantry_robot_command_t* p_command = (gantry_robot_command_t*) memstats_malloc(sizeof(gantry_robot_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_human_entry;
@@ -379,6 +503,9 @@ void gantry_human_entry(command_t* command)
     human_move_capture = false;
     human_move_done    = false;
 
+    // Time the human's turn
+    metrics_phase_begin(METRICS_HUMAN_THINK);
+
 #ifdef THREE_PARTY_MODE
     ready_to_read      = false;
 #endif
@@ -399,78 +526,41 @@ void gantry_human_action(command_t* command)
     }
 
     gantry_robot_command_t* p_gantry_command = (gantry_robot_command_t*) command; // WHY IS THIS A ROBOT COMMAND!?!?!
+    frame_t frame;
 
-    char message[9];
-    char move[5];
-    char check_bytes[2];
-    bool msg_status = false;
-
-    // Read the START byte
-    msg_status = uart_read_byte(USER_CHANNEL, (uint8_t*) &message[0]);
-    if ((!msg_status) || (message[0] != START_BYTE))
+    // Check for a complete, validated frame from the user
+    if (!rpi_get_user_frame(&frame))
     {
         return;
     }
 
-    // Read the INSTRUCTION byte
-    msg_status = uart_read_byte(USER_CHANNEL, (uint8_t*) &message[1]);
-    uint8_t instruction = message[1] >> 4;                          // Shift to remove the LENGTH portion from this section of this message
-    if ((!msg_status) || (instruction != HUMAN_MOVE_INSTR))
+    // If the user sent "illegal move", short circuit to robot_is_done
+    if (frame.instruction == ILLEGAL_MOVE_INSTR)
     {
-        // If the RPi responded "illegal move", receive the rest of the message, then short circuit to robot_is_done
-        if (instruction == ILLEGAL_MOVE_INSTR)
-        {
-            // Read the CHECK BYTES data and validate the transmission
-            msg_status = uart_read_string(USER_CHANNEL, check_bytes, 2);
-            if ((!msg_status) || (!utils_validate_transmission((uint8_t *) message, 2, check_bytes)))
-            {
-                return;
-            }
-
-            // No ACK's
-
-            // Turn on the error LED
-            led_mode(LED_ERROR);
-
-            // Mark the humans's move as illegal, the robot's move as done
-            human_move_legal = false;
-            p_gantry_command->move.move_type = IDLE;
-            robot_is_done = true;
-        }
-        return;
-    }
+        // No ACK's
 
-    // Read the MOVE bytes
-    msg_status = uart_read_string(USER_CHANNEL, move, 5);
-    if (!msg_status)
-    {
+        // Turn on the error LED
+        led_mode(LED_ERROR);
+
+        // Mark the humans's move as illegal, the robot's move as done
+        human_move_legal = false;
+        p_gantry_command->move.move_type = IDLE;
+        robot_is_done = true;
         return;
     }
-    message[2] = move[0];
-    message[3] = move[1];
-    message[4] = move[2];
-    message[5] = move[3];
-    message[6] = move[4];
-
-    // No GAME STATUS byte
 
-    // Read the CHECK BYTES data and validate the transmission
-    msg_status = uart_read_string(USER_CHANNEL, &check_bytes[0], 2);
-    if ((!msg_status) || (!utils_validate_transmission((uint8_t *) message, 7, check_bytes)))
+    // Otherwise, only a HUMAN_MOVE is expected (no GAME STATUS byte)
+    if ((frame.instruction != HUMAN_MOVE_INSTR) || (frame.length != FRAME_LENGTH(HUMAN_MOVE_INSTR_AND_LEN)))
     {
         return;
     }
 
-    // At this point, the full message was received properly. Copy the check bytes and transmit to the RPi    
-    message[7] = check_bytes[0];
-    message[8] = check_bytes[1];
-
     // Store the UCI for the Comm command
-    p_gantry_command->move_uci[0] = move[0];
-    p_gantry_command->move_uci[1] = move[1];
-    p_gantry_command->move_uci[2] = move[2];
-    p_gantry_command->move_uci[3] = move[3];
-    p_gantry_command->move_uci[4] = move[4];
+    p_gantry_command->move_uci[0] = frame.operands[0];
+    p_gantry_command->move_uci[1] = frame.operands[1];
+    p_gantry_command->move_uci[2] = frame.operands[2];
+    p_gantry_command->move_uci[3] = frame.operands[3];
+    p_gantry_command->move_uci[4] = frame.operands[4];
 
     human_move_done = true;
 #endif
@@ -483,6 +573,8 @@ void gantry_human_action(command_t* command)
  */
 void gantry_human_exit(command_t* command)
 {
+    metrics_phase_end(METRICS_HUMAN_THINK);
+
 #ifdef FINAL_IMPLEMENTATION_MODE
     // Make sure a reset has not been issued
     if (sys_reset || sys_limit)
@@ -490,9 +582,13 @@ void gantry_human_exit(command_t* command)
         return;
     }
 
-    // Update the board state from the reading
+    // Update the board state from the reading, masking out any squares with dead sensors
     human_move_legal = true;
     char move[5];
+    uint64_t expected_presence = (chessboard_get_previous_white_presence() | chessboard_get_previous_black_presence());
+    sensorhealth_check_turn(board_reading_current, expected_presence);
+    board_reading_intermediate = sensorhealth_mask_reading(board_reading_intermediate, expected_presence);
+    board_reading_current      = sensorhealth_mask_reading(board_reading_current, expected_presence);
 
     if (human_move_capture)
     {
@@ -508,7 +604,7 @@ void gantry_human_exit(command_t* command)
         // Place the gantry_comm command on the queue to send the message
         char message[HUMAN_MOVE_INSTR_LENGTH];
         rpi_build_human_move_msg(move, message);
-        command_queue_push((command_t*) gantry_comm_build_command(message, HUMAN_MOVE_INSTR_LENGTH));
+        gantry_comm_push(message, HUMAN_MOVE_INSTR_LENGTH);
         command_queue_push((command_t*) gantry_robot_build_command());
 
         // Prepare to send the COMM message
@@ -518,6 +614,7 @@ void gantry_human_exit(command_t* command)
     {
         // Change the LED's to indicate an error
         led_mode(LED_ERROR);
+        metrics_count(METRICS_ILLEGAL_BOARD);
         
         // Place the gantry_human command on the queue until a legal move is given
         command_queue_push((command_t*) gantry_human_build_command());
@@ -536,7 +633,7 @@ void gantry_human_exit(command_t* command)
     // Place the gantry_comm command on the queue to send the message
     char message[HUMAN_MOVE_INSTR_LENGTH];
     rpi_build_human_move_msg(p_gantry_command->move_uci, message);
-    command_queue_push((command_t*) gantry_comm_build_command(message, HUMAN_MOVE_INSTR_LENGTH));
+    gantry_comm_push(message, HUMAN_MOVE_INSTR_LENGTH);
     command_queue_push((command_t*) gantry_robot_build_command());
 
     // Prepare to send the COMM message
@@ -566,7 +663,11 @@ bool gantry_human_is_done(command_t* command)
 gantry_comm_command_t* gantry_comm_build_command(char* message, uint8_t message_length)
 {
     // The thing to return
-    gantry_comm_command_t* p_command = (gantry_comm_command_t*) malloc(sizeof(gantry_comm_command_t));
+    gantry_comm_command_t* p_command = (gantry_comm_command_t*) memstats_malloc(sizeof(gantry_comm_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_comm_entry;
@@ -585,6 +686,22 @@ gantry_comm_command_t* gantry_comm_build_command(char* message, uint8_t message_
     return p_command;
 }
 
+/**
+ * @brief Helper function to queue a comm command. A noisy link is first moved back to the default rate,
+ *  since the Pi is waiting on this message and no reply is in flight
+ *
+ * @param message The message to send
+ * @param message_length The length of the message
+ */
+static void gantry_comm_push(char* message, uint8_t message_length)
+{
+    if (rpi_check_link_errors())
+    {
+        command_queue_push((command_t*) rpi_baud_build_command(RPI_DEFAULT_BAUD_RATE));
+    }
+    command_queue_push((command_t*) gantry_comm_build_command(message, message_length));
+}
+
 /*
  * @brief Sends the supplied message once to guarantee it sends
  *
@@ -596,6 +713,7 @@ void gantry_comm_entry(command_t* command)
 
     // Indicate we're talking to the pi
     led_mode(LED_WAITING_FOR_MSG);
+    metrics_phase_begin(METRICS_COMM);
 
     // Send the message
     rpi_transmit(p_gantry_command->message, p_gantry_command->message_length);
@@ -603,44 +721,44 @@ void gantry_comm_entry(command_t* command)
     // Do not resend the message until the interrupt sets send_msg
     msg_ready_to_send = false;
 
-    // Start the timer
-    clock_reset_timer_value(COMM_TIMER);
-    clock_start_timer(COMM_TIMER);
+    // Start the timer, timed out by the link's current retransmission timeout
+    swtimer_arm(&comm_timer, rpi_get_rto_cycles() / TIMEBASE_CYCLES_PER_US, 0);
 }
 
 /*
- * @brief Sends the supplied message (every 5 seconds) until an ACK is received from the RPi
+ * @brief Resends the supplied message after each retransmission timeout until an ACK is received from the RPi
  *
  * @param command The gantry command being run
  */
 void gantry_comm_action(command_t* command)
 {
-    gantry_comm_command_t* p_gantry_command = (gantry_comm_command_t*) command;
-
-    // Message is ready for first try and every 5 seconds after
+    // Message is ready for first try and after every timeout
     if (msg_ready_to_send)
     {
-        // Send the message
-        rpi_transmit(p_gantry_command->message, p_gantry_command->message_length);
+        metrics_count(METRICS_COMM_TIMEOUTS);
+
+        // Resend the message (and anything else unacknowledged)
+        rpi_retransmit();
 
         // Do not resend the message until the interrupt sets send_msg
         msg_ready_to_send = false;
 
-        // Start the timer
-        clock_start_timer(COMM_TIMER);
+        // Restart the timer with the backed-off timeout
+        swtimer_arm(&comm_timer, rpi_get_rto_cycles() / TIMEBASE_CYCLES_PER_US, 0);
     }
 }
 
 /**
- * @brief Places a robot command command on the queue
+ * @brief Stops the comm timer
  *
  * @param command The gantry command being run
  */
 void gantry_comm_exit(command_t* command)
 {
-    // Stop and reset the timer
-    clock_stop_timer(COMM_TIMER);
-    clock_reset_timer_value(COMM_TIMER);
+    // Stop the timer
+    swtimer_cancel(&comm_timer);
+
+    metrics_phase_end(METRICS_COMM);
 }
 
 /**
@@ -651,14 +769,8 @@ void gantry_comm_exit(command_t* command)
  */
 bool gantry_comm_is_done(command_t* command)
 {
-    char ack_byte = '\0';
-    bool got_byte = false;
-
-    // Read from the Pi
-    got_byte = rpi_receive_unblocked(&ack_byte, 1);
-
     // If we get an ACK, we are done
-    return ((ack_byte == ACK_BYTE) && got_byte);
+    return rpi_get_ack();
 }
 
 /**
@@ -669,7 +781,11 @@ bool gantry_comm_is_done(command_t* command)
 gantry_robot_command_t* gantry_robot_build_command(void)
 {
     // The thing to return
-    gantry_robot_command_t* p_command = (gantry_robot_command_t*) malloc(sizeof(gantry_robot_command_t));
+    gantry_robot_command_t* p_command = (gantry_robot_command_t*) memstats_malloc(sizeof(gantry_robot_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_robot_entry;
@@ -706,6 +822,9 @@ void gantry_robot_entry(command_t* command)
     // Set the robot moving LED
     led_mode(LED_ROBOT_MOVE);
 
+    // Time the Pi's turn
+    metrics_phase_begin(METRICS_PI_THINK);
+
     // Reset everything
     robot_is_done = false;
     gantry_robot_move_cmd->move.source_file = FILE_ERROR;
@@ -716,7 +835,7 @@ void gantry_robot_entry(command_t* command)
 }
 
 /**
- * @brief Reads from the RPi until data has been received
+ * @brief Polls for a validated frame from the RPi until one has been received
  * 
  * @param command The gantry command being run
  */
@@ -726,71 +845,41 @@ void gantry_robot_action(command_t* command)
     uint8_t status_after_human = 0;
     uint8_t status_after_robot = 0;
     char move[5];
-    char message[8];
-    char check_bytes[2];
-    bool msg_status = false;
+    frame_t frame;
 
-    // Read the START byte
-    msg_status = rpi_receive(&message[0], 1);
-    if ((!msg_status) || (message[0] != START_BYTE))
+    // Check for a complete, validated frame from the Pi
+    if (!rpi_get_frame(&frame))
     {
         return;
     }
 
-    // Read the INSTRUCTION byte
-    msg_status = rpi_receive(&message[1], 1);
-    uint8_t instruction = message[1] >> 4;                          // Shift to remove the LENGTH portion from this section of this message
-    if ((!msg_status) || (instruction != ROBOT_MOVE_INSTR))
+    // If the RPi responded "illegal move", short circuit to robot_is_done
+    if (frame.instruction == ILLEGAL_MOVE_INSTR)
     {
-        // If the RPi responded "illegal move", receive the rest of the message, then short circuit to robot_is_done
-        if (instruction == ILLEGAL_MOVE_INSTR)
-        {
-            // Read the CHECK BYTES data and validate the transmission
-            msg_status = rpi_receive(check_bytes, 2);
-            if ((!msg_status) || (!utils_validate_transmission((uint8_t *) message, 2, check_bytes)))
-            {
-                return;
-            }
-
-            // Transmit an ACK
-            rpi_transmit_ack();
-
-            // Turn on the error LED
-            led_mode(LED_ERROR);
-
-            // Mark the humans's move as illegal, the robot's move as done
-            p_gantry_command->move.move_type = IDLE;
-            human_move_legal = false;
-            robot_is_done = true;
-        }
-        return;
-    }
+        // Transmit an ACK
+        rpi_transmit_ack();
 
-    // Read the MOVE bytes
-    msg_status = rpi_receive(move, 5);
-    if (!msg_status)
-    {
-        return;
-    }
-    message[2] = move[0];
-    message[3] = move[1];
-    message[4] = move[2];
-    message[5] = move[3];
-    message[6] = move[4];
-
-    // Read the GAME STATUS byte
-    msg_status = rpi_receive(&message[7], 1);
-    if (!msg_status)
-    {
+        // Turn on the error LED
+        led_mode(LED_ERROR);
+
+        // Mark the humans's move as illegal, the robot's move as done
+        p_gantry_command->move.move_type = IDLE;
+        human_move_legal = false;
+        robot_is_done = true;
+        metrics_count(METRICS_ILLEGAL_PI);
         return;
     }
 
-    // Read the CHECK BYTES data and validate the transmission
-    msg_status = rpi_receive(&check_bytes[0], 2);
-    if ((!msg_status) || (!utils_validate_transmission((uint8_t *) message, 8, check_bytes)))
+    // Otherwise, only a ROBOT_MOVE (MOVE bytes, then the GAME STATUS byte) is expected
+    if ((frame.instruction != ROBOT_MOVE_INSTR) || (frame.length != FRAME_LENGTH(ROBOT_MOVE_INSTR_AND_LEN)))
     {
         return;
     }
+    move[0] = frame.operands[0];
+    move[1] = frame.operands[1];
+    move[2] = frame.operands[2];
+    move[3] = frame.operands[3];
+    move[4] = frame.operands[4];
 
     // At this point, the full message was received properly. Transmit an ACK
     rpi_transmit_ack();
@@ -799,7 +888,7 @@ void gantry_robot_action(command_t* command)
     chessboard_update_previous_board_from_current_board();
 
     // To reduce the number of transmissions, game_status holds the status after the last human move and (possibly) the resulting robot move
-    char game_status = message[7];
+    char game_status = frame.operands[5];
     status_after_human = (game_status >> 4);
     status_after_robot = (game_status & 0x0F);
 
@@ -910,43 +999,33 @@ void gantry_robot_move_piece(chess_file_t initial_file, chess_rank_t initial_ran
 }
 
 /**
- * @brief Interprets the RPi's move, and adds the corresponding commands to the queue
+ * @brief Adds the commands that make a move (including the homing after it) to the queue. The board state
+ *  must not have been updated with the move yet
  *
- * @param command The gantry command being run
+ * @param p_move The move (nothing is queued for IDLE or an invalid move type)
  */
-void gantry_robot_exit(command_t* command)
+void gantry_robot_queue_move(chess_move_t* p_move)
 {
-    gantry_robot_command_t* p_gantry_command = (gantry_robot_command_t*) command;
-
-    // Make sure a reset has not been issued
-    if (sys_reset || sys_limit)
-    {
-        return;
-    }
+    chess_move_t rook_move;
+    chess_piece_t moving_piece;
 
-    // Special case of human made an illegal move
-    if (!human_move_legal)
+    // Time the move, up to the end of the homing that follows it
+    if (p_move->move_type != IDLE)
     {
-        // Turn on the error LED and go back to human move
-        led_mode(LED_ERROR);
-        command_queue_push((command_t*) gantry_human_build_command());
-        return;
+        metrics_count(METRICS_MOVES);
+        metrics_phase_begin(METRICS_ROBOT);
     }
-    
-    // Load commands based on the move that the RPi sent
-    chess_move_t rook_move;
-    chess_piece_t moving_piece;
 
-    switch (p_gantry_command->move.move_type)
+    switch (p_move->move_type)
     {
         case MOVE:
             // Make the move
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->source_file,
+                p_move->source_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
@@ -956,10 +1035,10 @@ void gantry_robot_exit(command_t* command)
 
         case PROMOTION:
             // Banish the source pawn to the graveyard
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
+                p_move->source_file,
+                p_move->source_rank,
                 CAPTURE_FILE,
                 CAPTURE_RANK,
                 moving_piece
@@ -970,8 +1049,8 @@ void gantry_robot_exit(command_t* command)
             gantry_robot_move_piece(
                 QUEEN_FILE,
                 QUEEN_RANK,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
@@ -981,20 +1060,20 @@ void gantry_robot_exit(command_t* command)
 
         case CAPTURE_PROMOTION:
             // Banish the piece being captured to the graveyard
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.dest_file, p_gantry_command->move.dest_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->dest_file, p_move->dest_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 CAPTURE_FILE,
                 CAPTURE_RANK,
                 moving_piece
             );
 
             // Banish the piece being captured to the graveyard
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
+                p_move->source_file,
+                p_move->source_rank,
                 CAPTURE_FILE,
                 CAPTURE_RANK,
                 moving_piece
@@ -1005,8 +1084,8 @@ void gantry_robot_exit(command_t* command)
             gantry_robot_move_piece(
                 QUEEN_FILE,
                 QUEEN_RANK,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
@@ -1016,22 +1095,22 @@ void gantry_robot_exit(command_t* command)
 
         case CAPTURE:
             // Banish the piece being captured to the graveyard
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.dest_file, p_gantry_command->move.dest_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->dest_file, p_move->dest_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 CAPTURE_FILE,
                 CAPTURE_RANK,
                 moving_piece
             );
 
             // Make the move
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->source_file,
+                p_move->source_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
@@ -1041,17 +1120,17 @@ void gantry_robot_exit(command_t* command)
 
         case CASTLING:
             // Move the king
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->source_file,
+                p_move->source_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
             // UCI notation gives us the king's move, determine the rook's move
-            rook_move = rpi_castle_get_rook_move(&p_gantry_command->move);
+            rook_move = rpi_castle_get_rook_move(p_move);
 
             // Move the rook
             moving_piece = ROOK;
@@ -1071,22 +1150,22 @@ void gantry_robot_exit(command_t* command)
             // With an en passant capture, the captured pawn will have the moving pawn's *source rank* and *destination file*
             
             // Banish the piece being captured to the graveyard
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.dest_file, p_gantry_command->move.dest_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->dest_file, p_move->dest_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.source_rank,
+                p_move->dest_file,
+                p_move->source_rank,
                 CAPTURE_FILE,
                 CAPTURE_RANK,
                 moving_piece
             );
 
             // Make the move
-            moving_piece = chessboard_get_piece_at_position(p_gantry_command->move.source_file, p_gantry_command->move.source_rank);
+            moving_piece = chessboard_get_piece_at_position(p_move->source_file, p_move->source_rank);
             gantry_robot_move_piece(
-                p_gantry_command->move.source_file,
-                p_gantry_command->move.source_rank,
-                p_gantry_command->move.dest_file,
-                p_gantry_command->move.dest_rank,
+                p_move->source_file,
+                p_move->source_rank,
+                p_move->dest_file,
+                p_move->dest_rank,
                 moving_piece
             );
 
@@ -1102,6 +1181,36 @@ void gantry_robot_exit(command_t* command)
             // Move was invalid, do nothing
         break;
     }
+}
+
+/**
+ * @brief Interprets the RPi's move, and adds the corresponding commands to the queue
+ *
+ * @param command The gantry command being run
+ */
+void gantry_robot_exit(command_t* command)
+{
+    gantry_robot_command_t* p_gantry_command = (gantry_robot_command_t*) command;
+
+    metrics_phase_end(METRICS_PI_THINK);
+
+    // Make sure a reset has not been issued
+    if (sys_reset || sys_limit)
+    {
+        return;
+    }
+
+    // Special case of human made an illegal move
+    if (!human_move_legal)
+    {
+        // Turn on the error LED and go back to human move
+        led_mode(LED_ERROR);
+        command_queue_push((command_t*) gantry_human_build_command());
+        return;
+    }
+    
+    // Load commands based on the move that the RPi sent
+    gantry_robot_queue_move(&p_gantry_command->move);
 
     // Check if the game is still going
     switch (p_gantry_command->game_status) 
@@ -1153,7 +1262,11 @@ bool gantry_robot_is_done(command_t* command)
 gantry_command_t* gantry_home_build_command(void)
 {
     // The thing to return
-    gantry_command_t* p_command = (gantry_command_t*) malloc(sizeof(gantry_command_t));
+    gantry_command_t* p_command = (gantry_command_t*) memstats_malloc(sizeof(gantry_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &gantry_home_entry;
@@ -1173,6 +1286,17 @@ void gantry_home_entry(command_t* command)
 {
     led_mode(LED_ROBOT_MOVE);
     gantry_homing = !gantry_homing;
+
+    // The homing after a robot move finishes the move
+    if (gantry_homing)
+    {
+        metrics_phase_begin(METRICS_HOMING);
+    }
+    else
+    {
+        metrics_phase_end(METRICS_HOMING);
+        metrics_phase_end(METRICS_ROBOT);
+    }
 }
 
 /**
@@ -1193,9 +1317,24 @@ bool gantry_home_is_done(command_t* command)
  */
 __interrupt void GANTRY_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_GANTRY);
+
     // Clear the interrupt flag
     clock_clear_interrupt(GANTRY_TIMER);
-    
+
+    // Keep the timebase from missing a cycle counter wrap
+    timebase_service();
+
+#ifdef SENSOR_DMA_SCAN
+    // Collect a finished sensor frame, if any
+    sensorscan_service();
+#endif
+
+#ifdef UART_DMA
+    // Re-arm the UART transfers and hand received bytes to the frame parsers
+    uartdma_service();
+#endif
+
     // Check the current switch readings
     uint16_t switch_data = switch_get_reading();
 
@@ -1212,47 +1351,80 @@ __interrupt void GANTRY_HANDLER(void)
         gantry_kill();
     }
 
-    // If the start/reset/home button was pressed, send the appropriate "new game" signal
-    if ((!sys_reset) && (switch_data & (BUTTON_RESET_MASK | BUTTON_START_MASK | BUTTON_HOME_MASK)))
+    // Handle each button/tile press exactly once
+    switch_event_t event;
+    while (switch_event_pop(&event))
     {
-        sys_reset = true;
-        command_queue_push((command_t*) gantry_reset_build_command());
-    }
+        if (event.type != SWITCH_PRESSED)
+        {
+            continue;
+        }
 
-    // Store the current reading if the human hit the capture tile
-    if ((!human_move_capture) && (switch_data & SWITCH_CAPTURE_MASK))
-    {
-        human_move_capture = true;
-        board_reading_intermediate = sensornetwork_get_reading();
-        led_mode(LED_CAPTURE);
-    }
+        // If the start/reset/home button was pressed, send the appropriate "new game" signal
+        if ((!sys_reset) && (event.mask & (BUTTON_RESET_MASK | BUTTON_START_MASK | BUTTON_HOME_MASK)))
+        {
+            sys_reset = true;
+            command_queue_push((command_t*) gantry_reset_build_command());
+        }
+
+        // Store the current reading if the human hit the capture tile
+        if ((!human_move_capture) && (event.mask & SWITCH_CAPTURE_MASK))
+        {
+            human_move_capture = true;
+            board_reading_intermediate = sensorhealth_get_reading();
+            led_mode(LED_CAPTURE);
+        }
 
 #ifdef FINAL_IMPLEMENTATION_MODE
-    // Store the current reading if the human hit the "end turn"" tile
-    if ((!human_move_done) && (switch_data & BUTTON_NEXT_TURN_MASK))
-    {
-        board_reading_current = sensornetwork_get_reading();
-        human_move_done = true;
-    }
+        // Store the current reading if the human hit the "end turn"" tile
+        if ((!human_move_done) && (event.mask & BUTTON_NEXT_TURN_MASK))
+        {
+            board_reading_current = sensorhealth_get_reading();
+            human_move_done = true;
+        }
 
 #elif defined(THREE_PARTY_MODE)
-    if ((!human_move_done) && (switch_data & BUTTON_NEXT_TURN_MASK))
-    {
-        ready_to_read = true;
-    }
+        if ((!human_move_done) && (event.mask & BUTTON_NEXT_TURN_MASK))
+        {
+            ready_to_read = true;
+        }
 #endif
+    }
+
+    ISRPROFILE_EXIT(ISRPROFILE_GANTRY);
 }
 
 /**
- * @brief Interrupt handler for the 5-second communication timer
+ * @brief Software timer callback for the communication timeout (runs in the software timer interrupt)
+ *
+ * @param p_context Unused
  */
-__interrupt void COMM_HANDLER(void)
+static void gantry_comm_timeout(void* p_context)
 {
-    // Clear the interrupt flag
-    clock_clear_interrupt(COMM_TIMER);
-
     // Indicate that the message timed out
     msg_ready_to_send = true;
 }
 
+/**
+ * @brief Interrupt handler for the E-stop and LIMIT_X closing edges
+ */
+__interrupt void SWITCH_EDGE_M_HANDLER(void)
+{
+    ISRPROFILE_ENTER(ISRPROFILE_SWITCH_EDGE);
+    uint32_t entry_cycles = utils_get_cycles();
+    gantry_switch_edge(switch_edge_get_pressed(SWITCH_EDGE_M_PORT), entry_cycles);
+    ISRPROFILE_EXIT(ISRPROFILE_SWITCH_EDGE);
+}
+
+/**
+ * @brief Interrupt handler for the LIMIT_Y and LIMIT_Z closing edges
+ */
+__interrupt void SWITCH_EDGE_K_HANDLER(void)
+{
+    ISRPROFILE_ENTER(ISRPROFILE_SWITCH_EDGE);
+    uint32_t entry_cycles = utils_get_cycles();
+    gantry_switch_edge(switch_edge_get_pressed(SWITCH_EDGE_K_PORT), entry_cycles);
+    ISRPROFILE_EXIT(ISRPROFILE_SWITCH_EDGE);
+}
+
 /* End gantry.c */
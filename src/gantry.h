@@ -20,37 +20,45 @@
 //  - gantry_comm_command:
 //      - Transmit the move
 //      - If ACK received, load a gantry_robot_command
-//      - Else, wait 5 seconds and retransmit
+//      - Else, retransmit after the link's retransmission timeout (adapts to the measured RTT)
 //  - gantry_robot_command:
 //      - Turn on the robot moving LED
 //      - Make the move specified
 //      - Turn off the robot moving LED
 //      - If the game is ONGOING, turn on human moving LED and load a gantry_human_command
 //      - Else, turn on a white LED and load no further commands (wait for reset)
+//  - E-stop/limits:
+//      - The closing edge interrupts and stops the motors immediately
+//      - GANTRY_HANDLER polls the switches every period and performs the full kill
+//      - Worst case for the polled path alone is one switch period plus one gantry period (~400us)
 
 #include "clock.h"
 #include "chessboard.h"
 #include "command_queue.h"
+#include "debug.h"
 #include "delay.h"
 #include "electromagnet.h"
 #include "gpio.h"
+#include "isrprofile.h"
 #include "led.h"
+#include "metrics.h"
+#include "pcsample.h"
 #include "raspberrypi.h"
+#include "sensorhealth.h"
 #include "sensornetwork.h"
+#include "sensorscan.h"
 #include "steppermotors.h"
 #include "switch.h"
+#include "swtimer.h"
+#include "timebase.h"
 #include "uart.h"
+#include "uartdma.h"
 #include "utils.h"
 
 // General gantry defines
 #define GANTRY_TIMER                        (TIMER4)
 #define GANTRY_HANDLER                      (TIMER4A_IRQHandler)
 
-// Communication defines
-#define COMM_TIMER                          (TIMER7)
-#define COMM_HANDLER                        (TIMER7A_IRQHandler)
-#define COMM_TIMEOUT                        (600000000)
-
 // Motor speed defines
 #define MOTORS_MOVE_V_X                     (1)
 #define MOTORS_MOVE_V_Y                     (1)
@@ -78,6 +86,9 @@ typedef struct gantry_comm_command_t {
 void gantry_init(void);
 void gantry_home(void);
 void gantry_robot_move_piece(chess_file_t initial_file, chess_rank_t initial_rank, chess_file_t final_file, chess_rank_t final_rank, chess_piece_t piece);
+void gantry_robot_queue_move(chess_move_t* p_move);
+uint32_t gantry_get_edge_stop_cycles_max(void);
+uint32_t gantry_get_poll_detect_cycles_max(void);
 
 // Command Functions (reading user input)
 gantry_command_t* gantry_human_build_command(void);
@@ -119,4 +119,36 @@ void gpio_select_alternate_function(GPIO_Type* port, uint8_t pin, uint8_t multip
     port->PCTL  |= (multiplex_val << (lsb_shift << 2)); // Shifts the desired value into the pin's lsb * 4
 }
 
+/* GPIO Interrupt Functions */
+
+/**
+ * @brief Configures input pins to interrupt on a falling edge (e.g., an active-low switch closing).
+ *  The port's NVIC interrupt must be enabled separately
+ * 
+ * @param port GPIO_Type for the port being used
+ * @param pin Pin(s) being used, GPIO_PIN_X for X={0,...,7}
+ */
+void gpio_set_falling_edge_interrupt(GPIO_Type* port, uint8_t pin)
+{
+    port->IM  &= ~pin;                                      // Mask while configuring
+    port->IS  &= ~pin;                                      // Edge-sensitive
+    port->IBE &= ~pin;                                      // Single edge
+    port->IEV &= ~pin;                                      // Falling edge
+    port->ICR  =  pin;                                      // Clear any stale edges
+    port->IM  |=  pin;                                      // Unmask
+}
+
+/**
+ * @brief Gets the pins with a pending, unmasked interrupt and clears them
+ * 
+ * @param port GPIO_Type for the port being used
+ * @return The pins that interrupted
+ */
+uint8_t gpio_get_and_clear_interrupt(GPIO_Type* port)
+{
+    uint8_t pins = (uint8_t) port->MIS;
+    port->ICR = pins;
+    return pins;
+}
+
 /* End gpio.c */
@@ -37,4 +37,8 @@ void gpio_set_as_input(GPIO_Type* port, uint8_t pin);
 uint8_t gpio_read_input(GPIO_Type* port, uint8_t pin);
 void gpio_select_alternate_function(GPIO_Type* port, uint8_t pin, uint8_t multiplex_val);
 
+// Functions for GPIO interrupts
+void gpio_set_falling_edge_interrupt(GPIO_Type* port, uint8_t pin);
+uint8_t gpio_get_and_clear_interrupt(GPIO_Type* port);
+
 #endif /* GPIO_H_ */
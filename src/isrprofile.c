@@ -0,0 +1,195 @@
+/**
+ * @file isrprofile.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Cycle-count profiler for the interrupt handlers
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "isrprofile.h"
+#include <stdio.h>
+#include <string.h>
+
+// Handler names for the report, indexed by isrprofile_isr_t
+static const char* const isr_names[NUMBER_OF_ISRPROFILE_ISRS] = {
+    [ISRPROFILE_STEPPER_X]   = "STEPPER_X",
+    [ISRPROFILE_STEPPER_Y]   = "STEPPER_Y",
+    [ISRPROFILE_STEPPER_Z]   = "STEPPER_Z",
+    [ISRPROFILE_SWITCH]      = "SWITCH",
+    [ISRPROFILE_SWITCH_EDGE] = "SWITCH_EDGE",
+    [ISRPROFILE_GANTRY]      = "GANTRY",
+    [ISRPROFILE_SWTIMER]     = "SWTIMER",
+    [ISRPROFILE_UART0]       = "UART0",
+    [ISRPROFILE_UART1]       = "UART1",
+    [ISRPROFILE_UART2]       = "UART2",
+    [ISRPROFILE_UART3]       = "UART3",
+    [ISRPROFILE_UART6]       = "UART6",
+};
+
+// Declare the statistics
+static isrprofile_stats_t stats[NUMBER_OF_ISRPROFILE_ISRS];
+static isrprofile_stats_t snapshot;         // Copy being reported
+
+// Nesting stack: time taken by the handlers that pre-empted each active handler
+static uint32_t nested_cycles[ISRPROFILE_MAX_NESTING];
+static uint8_t  depth = 0;
+
+/**
+ * @brief Marks the start of a handler (use ISRPROFILE_ENTER())
+ *
+ * @return The entry cycle count
+ */
+uint32_t isrprofile_enter(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (depth < ISRPROFILE_MAX_NESTING)
+    {
+        nested_cycles[depth] = 0;
+    }
+    depth++;
+    __set_PRIMASK(primask);
+
+    return utils_get_cycles();
+}
+
+/**
+ * @brief Marks the end of a handler and records its time (use ISRPROFILE_EXIT())
+ *
+ * @param isr The handler
+ * @param entry_cycles The cycle count from isrprofile_enter()
+ */
+void isrprofile_exit(isrprofile_isr_t isr, uint32_t entry_cycles)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t cycles  = utils_get_cycles() - entry_cycles;
+    uint32_t nested  = 0;
+    uint8_t  bin     = 0;
+    isrprofile_stats_t* p_stats = &stats[isr];
+
+    __disable_irq();
+
+    // Pop this handler, and charge its time to the one it pre-empted
+    depth--;
+    if (depth < ISRPROFILE_MAX_NESTING)
+    {
+        nested = nested_cycles[depth];
+    }
+    if ((depth > 0) && (depth <= ISRPROFILE_MAX_NESTING))
+    {
+        nested_cycles[depth - 1] += cycles;
+    }
+
+    // Summary
+    p_stats->count++;
+    p_stats->total_cycles += cycles;
+    if ((p_stats->count == 1) || (cycles < p_stats->min_cycles))
+    {
+        p_stats->min_cycles = cycles;
+    }
+    if (cycles > p_stats->max_cycles)
+    {
+        p_stats->max_cycles = cycles;
+    }
+    if (nested > 0)
+    {
+        p_stats->preempted++;
+        p_stats->preempted_cycles += nested;
+    }
+
+    // Histogram bin is the index of the highest set bit
+    bin = 31 - __CLZ(cycles | 1);
+    if (bin >= ISRPROFILE_HISTOGRAM_BINS)
+    {
+        bin = ISRPROFILE_HISTOGRAM_BINS - 1;
+    }
+    p_stats->histogram[bin]++;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Clears every handler's statistics
+ */
+void isrprofile_reset(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(stats, 0, sizeof(stats));
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Gets a consistent copy of a handler's statistics
+ *
+ * @param isr The handler
+ * @return A copy of the statistics
+ */
+isrprofile_stats_t isrprofile_get_stats(isrprofile_isr_t isr)
+{
+    uint32_t primask = __get_PRIMASK();
+    isrprofile_stats_t copy;
+
+    __disable_irq();
+    copy = stats[isr];
+    __set_PRIMASK(primask);
+
+    return copy;
+}
+
+/**
+ * @brief Writes one line of the text report (a debug port writer). Each handler takes
+ *        ISRPROFILE_RECORDS_PER_ISR lines: counts, cycle summary, then the histogram four bins at a time
+ *
+ * @param index Line number
+ * @param p_buffer Storage for the line
+ * @param size Size of the buffer
+ * @return The line length (0 once the report is done)
+ */
+uint8_t isrprofile_write_report(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    uint16_t isr  = index / ISRPROFILE_RECORDS_PER_ISR;
+    uint16_t part = index % ISRPROFILE_RECORDS_PER_ISR;
+    int length    = 0;
+
+    if (isr >= NUMBER_OF_ISRPROFILE_ISRS)
+    {
+        return 0;
+    }
+
+    if (part == 0)
+    {
+        // Every line of a handler comes from the same copy
+        snapshot = isrprofile_get_stats((isrprofile_isr_t) isr);
+        length = snprintf((char*) p_buffer, size, "%s n=%lu pre=%lu/%llu\r\n", isr_names[isr],
+                          (unsigned long) snapshot.count, (unsigned long) snapshot.preempted,
+                          (unsigned long long) snapshot.preempted_cycles);
+    }
+    else if (part == 1)
+    {
+        uint32_t average = (snapshot.count > 0) ? (uint32_t) (snapshot.total_cycles / snapshot.count) : 0;
+        length = snprintf((char*) p_buffer, size, "  min=%lu avg=%lu max=%lu\r\n",
+                          (unsigned long) snapshot.min_cycles, (unsigned long) average,
+                          (unsigned long) snapshot.max_cycles);
+    }
+    else
+    {
+        uint8_t bin = (part - 2) * 4;
+        length = snprintf((char*) p_buffer, size, "  h%u: %lu %lu %lu %lu\r\n", bin,
+                          (unsigned long) snapshot.histogram[bin], (unsigned long) snapshot.histogram[bin + 1],
+                          (unsigned long) snapshot.histogram[bin + 2], (unsigned long) snapshot.histogram[bin + 3]);
+    }
+
+    // A truncated line is still sent
+    if (length >= size)
+    {
+        length = size - 1;
+    }
+    return (length > 0) ? (uint8_t) length : 0;
+}
+
+/* End isrprofile.c */
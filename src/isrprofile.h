@@ -0,0 +1,78 @@
+/**
+ * @file isrprofile.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Cycle-count profiler for the interrupt handlers
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef ISRPROFILE_H_
+#define ISRPROFILE_H_
+
+// Note on ISR profiling (enabled with ISR_PROFILING in utils.h):
+//  - Every handler starts with ISRPROFILE_ENTER() and ends with ISRPROFILE_EXIT(), which read the DWT cycle
+//      counter. Without ISR_PROFILING, both expand to nothing
+//  - Each handler keeps its run count, min/avg/max entry-to-exit cycles, and a log2 histogram (bin n counts
+//      runs of 2^n to 2^(n+1)-1 cycles, the last bin also counts anything longer)
+//  - Entry-to-exit time includes any higher priority handler that pre-empted it. A small nesting stack
+//      counts how many runs were pre-empted, and how long the pre-empting handlers took
+//  - The report is read with the DEBUG_PORT 'i' command ('I' clears the statistics)
+//  - Overhead is roughly 40 cycles per handler run
+
+#include "msp.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General profiler defines
+#define ISRPROFILE_HISTOGRAM_BINS           (16)
+#define ISRPROFILE_MAX_NESTING              (8)         // One per NVIC priority level in use
+#define ISRPROFILE_RECORDS_PER_ISR          (2 + (ISRPROFILE_HISTOGRAM_BINS / 4))
+
+// Profiled handlers
+typedef enum isrprofile_isr_t {
+    ISRPROFILE_STEPPER_X,
+    ISRPROFILE_STEPPER_Y,
+    ISRPROFILE_STEPPER_Z,
+    ISRPROFILE_SWITCH,
+    ISRPROFILE_SWITCH_EDGE,
+    ISRPROFILE_GANTRY,
+    ISRPROFILE_SWTIMER,
+    ISRPROFILE_UART0,
+    ISRPROFILE_UART1,
+    ISRPROFILE_UART2,
+    ISRPROFILE_UART3,
+    ISRPROFILE_UART6,
+    NUMBER_OF_ISRPROFILE_ISRS
+} isrprofile_isr_t;
+
+// Statistics of one handler
+typedef struct isrprofile_stats_t {
+    uint32_t count;
+    uint32_t min_cycles;
+    uint32_t max_cycles;
+    uint64_t total_cycles;
+    uint32_t preempted;                             // Runs that were interrupted by another handler
+    uint64_t preempted_cycles;                      // Time spent in the pre-empting handlers
+    uint32_t histogram[ISRPROFILE_HISTOGRAM_BINS];
+} isrprofile_stats_t;
+
+// Instrumentation hooks
+#ifdef ISR_PROFILING
+#define ISRPROFILE_ENTER(isr)               uint32_t isrprofile_entry_cycles = isrprofile_enter()
+#define ISRPROFILE_EXIT(isr)                isrprofile_exit((isr), isrprofile_entry_cycles)
+#else
+#define ISRPROFILE_ENTER(isr)
+#define ISRPROFILE_EXIT(isr)
+#endif
+
+// Public functions
+uint32_t isrprofile_enter(void);
+void isrprofile_exit(isrprofile_isr_t isr, uint32_t entry_cycles);
+void isrprofile_reset(void);
+isrprofile_stats_t isrprofile_get_stats(isrprofile_isr_t isr);
+uint8_t isrprofile_write_report(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+#endif /* ISRPROFILE_H_ */
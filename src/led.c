@@ -16,6 +16,7 @@ static void led_disable(led_t* p_led);
 static void led_toggle(led_t* p_led);
 static void led_start_flash();
 static void led_stop_flash();
+static void led_flash(void* p_context);
 
 // Declare the LEDs
 led_t leds[NUMBER_OF_LEDS];
@@ -27,6 +28,7 @@ static led_t* p_led_green = &leds[2];
 static bool led_red_status   = false;
 static bool led_green_status = false;
 static bool led_blue_status  = false;
+static swtimer_t flash_timer;
 
 /**
  * @brief Initialize all LEDs
@@ -48,6 +50,9 @@ void led_init(void)
     gpio_set_output_low(RGB_GREEN_PORT, RGB_GREEN_PIN);
     p_led_green->enable_port = RGB_GREEN_PORT;
     p_led_green->enable_pin  = RGB_GREEN_PIN;
+
+    // Flashing is driven by a software timer
+    swtimer_setup(&flash_timer, &led_flash, 0);
 }
 
 /**
@@ -86,9 +91,9 @@ static void led_toggle(led_t* p_led)
  */
 static void led_start_flash()
 {
-    if (!clock_active(LED_TIMER))
+    if (!swtimer_is_armed(&flash_timer))
     {
-        clock_start_timer(LED_TIMER);
+        swtimer_arm(&flash_timer, LED_FLASH_PERIOD_US, LED_FLASH_PERIOD_US);
     }
 }
 
@@ -97,7 +102,7 @@ static void led_start_flash()
  */
 static void led_stop_flash()
 {
-    clock_stop_timer(LED_TIMER);
+    swtimer_cancel(&flash_timer);
 }
 
 /**
@@ -246,13 +251,12 @@ void led_mode(led_indicator_t indicator)
 }
 
 /**
- * @brief Interrupt handler for the LED module
+ * @brief Software timer callback that flashes the LEDs (runs in the software timer interrupt)
+ *
+ * @param p_context Unused
  */
-__interrupt void LED_HANDLER(void)
+static void led_flash(void* p_context)
 {
-    // Clear the interrupt flag
-    clock_clear_interrupt(LED_TIMER);
-
     // Toggle any LED that is on
     if (led_red_status)
     {
@@ -19,13 +19,13 @@
 #include "msp.h"
 #include "clock.h"
 #include "gpio.h"
+#include "swtimer.h"
 #include <stdint.h>
 #include <stdlib.h>
 
 // General LED macros
 #define NUMBER_OF_LEDS                      (3)
-#define LED_TIMER                           (TIMER6)
-#define LED_HANDLER                         (TIMER6A_IRQHandler)
+#define LED_FLASH_PERIOD_US                 (500000)    // Toggle every 0.5s
 
 // Game status LED macros
 #define RGB_RED_PORT                        (GPIOC)
@@ -13,10 +13,14 @@
 
 #include "msp.h"
 #include "gantry.h"
+#include "debug.h"
+#include "replay.h"
+#include "trace.h"
 
 int main(void)
 {
     // System level initialization
+    memstats_init();
     command_queue_init();
     gantry_init();
 
@@ -29,6 +33,10 @@ int main(void)
     command_queue_push((command_t*) delay_build_command(1000));
     command_queue_push((command_t*) stepper_build_chess_z_command(HOME_PIECE, 1));
 
+#elif defined(REPLAY_MODE)
+    // Benchmark the robot on a recorded game
+    replay_start();
+
 #else
     // Play chess
     command_queue_push((command_t*) gantry_reset_build_command());
@@ -44,10 +52,13 @@ int main(void)
         if (!command_queue_pop(&p_current_command))
         {
             // Something went wrong. Probably ran out of commands
+            DEBUG_SERVICE();
         }
         else
         {
+            TRACE_COMMAND_BEGIN(p_current_command);
             p_current_command->p_entry(p_current_command);
+            TRACE_COMMAND_ACTION();
 
             // Run the action function - is_done() determines when action is complete
             while (!p_current_command->p_is_done(p_current_command))
@@ -66,13 +77,17 @@ int main(void)
                     break;
                 }
                 p_current_command->p_action(p_current_command);
+                TRACE_COMMAND_ITERATION();
+                DEBUG_SERVICE();
             }
 
             // Run the exit function
+            TRACE_COMMAND_EXIT();
             p_current_command->p_exit(p_current_command);
+            TRACE_COMMAND_END();
 
             // Free the command memory
-            free(p_current_command);
+            memstats_free(p_current_command);
         }
     }
 }
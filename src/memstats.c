@@ -0,0 +1,138 @@
+/**
+ * @file memstats.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Heap usage counters and stack high-water measurement
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "memstats.h"
+#include "utils.h"
+
+// Linker symbols bounding the stack (it grows down from __STACK_TOP towards __stack)
+extern uint32_t __stack;
+extern uint32_t __STACK_TOP;
+
+// Declare the heap counters
+static uint32_t heap_in_use = 0;
+static uint32_t heap_peak   = 0;
+static uint32_t allocations = 0;
+static uint32_t failures    = 0;
+
+/**
+ * @brief Paints the unused part of the stack (call first thing in main())
+ */
+void memstats_init(void)
+{
+    uint32_t* p_word = &__stack;
+    uint32_t* p_stop = ((uint32_t*) (uintptr_t) __get_MSP()) - MEMSTATS_STACK_GUARD_WORDS;
+
+    while (p_word < p_stop)
+    {
+        *p_word = MEMSTATS_STACK_PAINT;
+        p_word++;
+    }
+}
+
+/**
+ * @brief Allocates a block and counts it
+ *
+ * @param size Bytes needed
+ * @return The block, or 0 if the heap is out of room (sys_fault is set)
+ */
+void* memstats_malloc(size_t size)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t* p_block = 0;
+
+    __disable_irq();
+    p_block = (uint8_t*) malloc(size + MEMSTATS_HEADER_SIZE);
+    if (p_block)
+    {
+        *((uint32_t*) p_block) = size;
+        p_block += MEMSTATS_HEADER_SIZE;
+
+        allocations++;
+        heap_in_use += size;
+        if (heap_in_use > heap_peak)
+        {
+            heap_peak = heap_in_use;
+        }
+    }
+    else
+    {
+        // Running out of heap is a system fault
+        failures++;
+        sys_fault = true;
+    }
+    __set_PRIMASK(primask);
+
+    return p_block;
+}
+
+/**
+ * @brief Frees a block from memstats_malloc()
+ *
+ * @param p_block The block (ignored if 0)
+ */
+void memstats_free(void* p_block)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint8_t* p_start = 0;
+
+    if (!p_block)
+    {
+        return;
+    }
+
+    __disable_irq();
+    p_start = ((uint8_t*) p_block) - MEMSTATS_HEADER_SIZE;
+    heap_in_use -= *((uint32_t*) p_start);
+    free(p_start);
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Finds the deepest stack use since reset
+ *
+ * @return The high-water mark (bytes)
+ */
+uint32_t memstats_get_stack_peak(void)
+{
+    uint32_t* p_word = &__stack;
+
+    // The first word without the paint was used at some point
+    while ((p_word < &__STACK_TOP) && (*p_word == MEMSTATS_STACK_PAINT))
+    {
+        p_word++;
+    }
+
+    return (uint32_t) ((uint8_t*) &__STACK_TOP - (uint8_t*) p_word);
+}
+
+/**
+ * @brief Gets a consistent copy of the statistics
+ *
+ * @return The statistics
+ */
+memstats_t memstats_get(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    memstats_t stats;
+
+    __disable_irq();
+    stats.heap_in_use = heap_in_use;
+    stats.heap_peak   = heap_peak;
+    stats.allocations = allocations;
+    stats.failures    = failures;
+    __set_PRIMASK(primask);
+
+    stats.stack_size = (uint32_t) ((uint8_t*) &__STACK_TOP - (uint8_t*) &__stack);
+    stats.stack_peak = memstats_get_stack_peak();
+
+    return stats;
+}
+
+/* End memstats.c */
@@ -0,0 +1,53 @@
+/**
+ * @file memstats.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Heap usage counters and stack high-water measurement
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef MEMSTATS_H_
+#define MEMSTATS_H_
+
+// Note on the memory statistics:
+//  - Commands are allocated with memstats_malloc() and freed with memstats_free(), which count bytes in use,
+//      the peak, allocations, and failures. Each block carries a MEMSTATS_HEADER_SIZE byte header holding its
+//      size (not counted in the byte totals), so the heap fills MEMSTATS_HEADER_SIZE bytes per block sooner
+//  - Allocation runs with interrupts masked, since commands are also built in GANTRY_HANDLER (e.g., a reset)
+//  - A failed allocation sets sys_fault, since skipping one command mid-sequence (e.g., a single move of a
+//      capture) leaves the board in an unknown state. It still returns 0, so builders return 0 and
+//      command_queue_push() rejects it, and main() stops before the next action
+//  - memstats_init() paints the unused stack with MEMSTATS_STACK_PAINT. The high-water mark is the lowest
+//      word that no longer holds the paint, found by scanning up from the stack's base
+//  - Both are reported in the metrics frame (see metrics.h)
+
+#include "msp.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+// General memory statistics defines
+#define MEMSTATS_HEADER_SIZE                (8)         // Keeps blocks 8-byte aligned
+#define MEMSTATS_STACK_PAINT                (0xA5A5A5A5)
+#define MEMSTATS_STACK_GUARD_WORDS          (16)        // Left unpainted below the stack pointer in memstats_init()
+
+// Memory statistics
+typedef struct memstats_t {
+    uint32_t heap_in_use;                           // Bytes (requested sizes)
+    uint32_t heap_peak;
+    uint32_t allocations;
+    uint32_t failures;
+    uint32_t stack_size;                            // Bytes
+    uint32_t stack_peak;                            // Deepest use seen (bytes)
+} memstats_t;
+
+// Public functions
+void memstats_init(void);
+void* memstats_malloc(size_t size);
+void memstats_free(void* p_block);
+uint32_t memstats_get_stack_peak(void);
+memstats_t memstats_get(void);
+
+#endif /* MEMSTATS_H_ */
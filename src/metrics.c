@@ -0,0 +1,318 @@
+/**
+ * @file metrics.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Per-game timing and event counters, exported as one binary status frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "metrics.h"
+#include "raspberrypi.h"
+#include <string.h>
+
+// Private functions
+static void metrics_record(metrics_phase_t phase, uint64_t elapsed_us);
+static uint8_t metrics_put16(uint8_t* p_frame, uint8_t offset, uint16_t value);
+static uint8_t metrics_put32(uint8_t* p_frame, uint8_t offset, uint32_t value);
+
+// Declare the metrics (written by commands, read by the debug port with interrupts masked)
+static metrics_summary_t summaries[NUMBER_OF_METRICS_PHASES];
+static uint16_t counters[NUMBER_OF_METRICS_COUNTERS];
+static uint16_t game_number    = 0;
+static uint64_t game_start_us  = 0;
+
+// Open phases
+static uint64_t phase_start_us[NUMBER_OF_METRICS_PHASES];
+static bool phase_open[NUMBER_OF_METRICS_PHASES];
+static metrics_phase_t motion  = NUMBER_OF_METRICS_PHASES;     // Open motion phase (none if NUMBER_OF_METRICS_PHASES)
+
+// Frame being sent
+static uint8_t frame[METRICS_FRAME_SIZE];
+static uint8_t frame_length    = 0;
+
+/**
+ * @brief Clears every metric for a new game (called by each reset)
+ */
+void metrics_new_game(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    memset(summaries, 0, sizeof(summaries));
+    memset(counters, 0, sizeof(counters));
+    memset(phase_open, 0, sizeof(phase_open));
+    motion = NUMBER_OF_METRICS_PHASES;
+    game_number++;
+    game_start_us = timebase_now_us();
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Starts timing a phase (restarts it if already open)
+ *
+ * @param phase The phase
+ */
+void metrics_phase_begin(metrics_phase_t phase)
+{
+    phase_start_us[phase] = timebase_now_us();
+    phase_open[phase] = true;
+}
+
+/**
+ * @brief Stops timing a phase and records it, unless a reset/limit cut it short. Does nothing if the phase
+ *        is not open
+ *
+ * @param phase The phase
+ */
+void metrics_phase_end(metrics_phase_t phase)
+{
+    if (!phase_open[phase])
+    {
+        return;
+    }
+
+    phase_open[phase] = false;
+    if (!(sys_reset || sys_limit))
+    {
+        metrics_record(phase, timebase_now_us() - phase_start_us[phase]);
+    }
+}
+
+/**
+ * @brief Stops timing a phase without recording it (e.g., after a reset)
+ *
+ * @param phase The phase
+ */
+void metrics_phase_cancel(metrics_phase_t phase)
+{
+    phase_open[phase] = false;
+}
+
+/**
+ * @brief Checks if a phase is being timed
+ *
+ * @param phase The phase
+ * @return Whether the phase is open
+ */
+bool metrics_phase_is_open(metrics_phase_t phase)
+{
+    return phase_open[phase];
+}
+
+/**
+ * @brief Starts timing one motion of the robot's move (METRICS_TRAVEL, METRICS_Z, or METRICS_DWELL). Motions
+ *        outside of a robot move, or while homing, are not timed
+ *
+ * @param phase The motion phase
+ */
+void metrics_motion_begin(metrics_phase_t phase)
+{
+    if ((!phase_open[METRICS_ROBOT]) || (phase_open[METRICS_HOMING]))
+    {
+        return;
+    }
+
+    motion = phase;
+    metrics_phase_begin(phase);
+}
+
+/**
+ * @brief Stops timing the open motion, if any (from a command's exit function)
+ */
+void metrics_motion_end(void)
+{
+    if (motion == NUMBER_OF_METRICS_PHASES)
+    {
+        return;
+    }
+
+    metrics_phase_end(motion);
+    motion = NUMBER_OF_METRICS_PHASES;
+}
+
+/**
+ * @brief Counts one event
+ *
+ * @param counter The event
+ */
+void metrics_count(metrics_counter_t counter)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    counters[counter]++;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Gets a consistent copy of a phase's summary
+ *
+ * @param phase The phase
+ * @return A copy of the summary
+ */
+metrics_summary_t metrics_get_summary(metrics_phase_t phase)
+{
+    uint32_t primask = __get_PRIMASK();
+    metrics_summary_t copy;
+
+    __disable_irq();
+    copy = summaries[phase];
+    __set_PRIMASK(primask);
+
+    return copy;
+}
+
+/**
+ * @brief Builds the status frame (see the note in metrics.h)
+ *
+ * @param p_frame Storage for the frame, at least METRICS_FRAME_SIZE long
+ * @return The frame length
+ */
+uint8_t metrics_build_frame(uint8_t* p_frame)
+{
+    metrics_summary_t copy[NUMBER_OF_METRICS_PHASES];
+    uint16_t counts[NUMBER_OF_METRICS_COUNTERS];
+    uint32_t primask = __get_PRIMASK();
+    uint32_t game_ms = 0;
+    uint16_t game    = 0;
+    uint8_t offset   = 0;
+    uint8_t i        = 0;
+
+    // Copy everything at once, so the frame is consistent
+    __disable_irq();
+    memcpy(copy, summaries, sizeof(copy));
+    memcpy(counts, counters, sizeof(counts));
+    game = game_number;
+    game_ms = (uint32_t) ((timebase_now_us() - game_start_us) / 1000);
+    __set_PRIMASK(primask);
+
+    // Header
+    p_frame[offset++] = 'G';
+    p_frame[offset++] = 'M';
+    p_frame[offset++] = METRICS_FORMAT_VERSION;
+    p_frame[offset++] = METRICS_PAYLOAD_SIZE;
+
+    // Counters
+    offset = metrics_put16(p_frame, offset, game);
+    for (i = 0; i < NUMBER_OF_METRICS_COUNTERS; i++)
+    {
+        offset = metrics_put16(p_frame, offset, counts[i]);
+    }
+    offset = metrics_put16(p_frame, offset, 0);
+    offset = metrics_put32(p_frame, offset, game_ms);
+    offset = metrics_put32(p_frame, offset, rpi_get_rtt_stats().srtt_us);
+
+    // Memory
+    memstats_t memory = memstats_get();
+    offset = metrics_put16(p_frame, offset, memory.heap_in_use);
+    offset = metrics_put16(p_frame, offset, memory.heap_peak);
+    offset = metrics_put32(p_frame, offset, memory.allocations);
+    offset = metrics_put16(p_frame, offset, memory.failures);
+    offset = metrics_put16(p_frame, offset, memory.stack_peak);
+
+    // Phase summaries
+    for (i = 0; i < NUMBER_OF_METRICS_PHASES; i++)
+    {
+        offset = metrics_put16(p_frame, offset, copy[i].count);
+        offset = metrics_put32(p_frame, offset, copy[i].total_ms);
+        offset = metrics_put32(p_frame, offset, copy[i].max_ms);
+    }
+
+    // Check bytes
+    utils_fl16_data_to_checkbytes(p_frame, offset, (char*) &p_frame[offset]);
+    offset += 2;
+
+    return offset;
+}
+
+/**
+ * @brief Writes one piece of the status frame (a debug port writer). The frame is built on the first piece
+ *
+ * @param index Piece number
+ * @param p_buffer Storage for the piece
+ * @param size Size of the buffer
+ * @return The piece length (0 once the frame is sent)
+ */
+uint8_t metrics_write_frame(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    uint16_t offset = index * METRICS_WRITE_SIZE;
+    uint8_t length  = 0;
+
+    if (index == 0)
+    {
+        frame_length = metrics_build_frame(frame);
+    }
+
+    if (offset >= frame_length)
+    {
+        return 0;
+    }
+
+    length = frame_length - offset;
+    if (length > METRICS_WRITE_SIZE)
+    {
+        length = METRICS_WRITE_SIZE;
+    }
+    if (length > size)
+    {
+        length = size;
+    }
+
+    memcpy(p_buffer, &frame[offset], length);
+    return length;
+}
+
+/**
+ * @brief Helper function to add a finished phase to its summary
+ *
+ * @param phase The phase
+ * @param elapsed_us How long it took
+ */
+static void metrics_record(metrics_phase_t phase, uint64_t elapsed_us)
+{
+    uint32_t primask    = __get_PRIMASK();
+    uint32_t elapsed_ms = (uint32_t) (elapsed_us / 1000);
+
+    __disable_irq();
+    summaries[phase].count++;
+    summaries[phase].total_ms += elapsed_ms;
+    if (elapsed_ms > summaries[phase].max_ms)
+    {
+        summaries[phase].max_ms = elapsed_ms;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Helper function to store a little-endian 16 bit value in the frame
+ *
+ * @param p_frame The frame
+ * @param offset Where to store it
+ * @param value The value
+ * @return The offset after the value
+ */
+static uint8_t metrics_put16(uint8_t* p_frame, uint8_t offset, uint16_t value)
+{
+    p_frame[offset]     = (value & 0xFF);
+    p_frame[offset + 1] = ((value >> 8) & 0xFF);
+
+    return offset + 2;
+}
+
+/**
+ * @brief Helper function to store a little-endian 32 bit value in the frame
+ *
+ * @param p_frame The frame
+ * @param offset Where to store it
+ * @param value The value
+ * @return The offset after the value
+ */
+static uint8_t metrics_put32(uint8_t* p_frame, uint8_t offset, uint32_t value)
+{
+    offset = metrics_put16(p_frame, offset, (value & 0xFFFF));
+    return metrics_put16(p_frame, offset, ((value >> 16) & 0xFFFF));
+}
+
+/* End metrics.c */
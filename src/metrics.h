@@ -0,0 +1,92 @@
+/**
+ * @file metrics.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Per-game timing and event counters, exported as one binary status frame
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+// Note on the game metrics:
+//  - Phases are timed at the command boundaries, and cleared by every reset (one set per game):
+//      - METRICS_HUMAN_THINK:  gantry_human entry to exit (the human pressed "end turn")
+//      - METRICS_COMM:         gantry_comm entry to exit (the Pi ACKed the message)
+//      - METRICS_PI_THINK:     gantry_robot entry to exit (the Pi's move arrived)
+//      - METRICS_ROBOT:        gantry_robot exit to the end of the homing that follows the move
+//      - METRICS_TRAVEL/Z:     chess XY/Z stepper moves of the robot's move (not homing)
+//      - METRICS_DWELL:        delays of the robot's move
+//      - METRICS_HOMING:       between the two gantry_home toggles
+//  - A phase cut short by a reset/limit is dropped, not recorded
+//  - The counters are robot moves made, illegal moves (found by the board or by the Pi), and comm timeouts
+//  - The DEBUG_PORT 'm' command sends the frame (METRICS_FRAME_SIZE bytes, little-endian):
+//      - 'G', 'M', METRICS_FORMAT_VERSION, payload length
+//      - Game number, moves, board illegal moves, Pi illegal moves, comm timeouts (uint16_t each),
+//          reserved (uint16_t), game time (uint32_t, ms), and the link's smoothed RTT (uint32_t, us)
+//      - Memory since power-up: heap bytes in use, heap peak (uint16_t each), allocations (uint32_t),
+//          allocation failures, and stack high-water mark in bytes (uint16_t each, see memstats.h)
+//      - For each phase: count (uint16_t), total (uint32_t, ms), max (uint32_t, ms)
+//      - Fletcher-16 check bytes over everything before them (see utils_fl16_data_to_checkbytes())
+//  - The frame is built from a copy taken with interrupts masked, so polling never stalls the game
+
+#include "msp.h"
+#include "memstats.h"
+#include "timebase.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Timed phases
+typedef enum metrics_phase_t {
+    METRICS_HUMAN_THINK,
+    METRICS_COMM,
+    METRICS_PI_THINK,
+    METRICS_ROBOT,
+    METRICS_TRAVEL,
+    METRICS_Z,
+    METRICS_DWELL,
+    METRICS_HOMING,
+    NUMBER_OF_METRICS_PHASES
+} metrics_phase_t;
+
+// Counted events
+typedef enum metrics_counter_t {
+    METRICS_MOVES,
+    METRICS_ILLEGAL_BOARD,
+    METRICS_ILLEGAL_PI,
+    METRICS_COMM_TIMEOUTS,
+    NUMBER_OF_METRICS_COUNTERS
+} metrics_counter_t;
+
+// General metrics defines
+#define METRICS_FORMAT_VERSION              (2)
+#define METRICS_HEADER_SIZE                 (4)
+#define METRICS_SUMMARY_SIZE                (10)
+#define METRICS_PAYLOAD_SIZE                (32 + (NUMBER_OF_METRICS_PHASES * METRICS_SUMMARY_SIZE))
+#define METRICS_FRAME_SIZE                  (METRICS_HEADER_SIZE + METRICS_PAYLOAD_SIZE + 2)
+#define METRICS_WRITE_SIZE                  (40)        // Frame bytes per debug port write
+
+// Latency summary of one phase
+typedef struct metrics_summary_t {
+    uint16_t count;
+    uint32_t total_ms;
+    uint32_t max_ms;
+} metrics_summary_t;
+
+// Public functions
+void metrics_new_game(void);
+void metrics_phase_begin(metrics_phase_t phase);
+void metrics_phase_end(metrics_phase_t phase);
+void metrics_phase_cancel(metrics_phase_t phase);
+bool metrics_phase_is_open(metrics_phase_t phase);
+void metrics_motion_begin(metrics_phase_t phase);
+void metrics_motion_end(void);
+void metrics_count(metrics_counter_t counter);
+metrics_summary_t metrics_get_summary(metrics_phase_t phase);
+uint8_t metrics_build_frame(uint8_t* p_frame);
+uint8_t metrics_write_frame(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,139 @@
+/**
+ * @file pcsample.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Statistical profiler that samples the interrupted program counter
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "pcsample.h"
+#include <string.h>
+
+// Declare the ring (head is only written by PCSAMPLE_HANDLER, tail only by the debug port)
+static uint32_t ring[PCSAMPLE_RING_SIZE];
+static volatile uint32_t head    = 0;
+static volatile uint32_t tail    = 0;
+static volatile uint32_t dropped = 0;
+
+// Samples left in the dump being sent
+static uint16_t dump_remaining = 0;
+
+/**
+ * @brief Initializes and starts the sampling timer
+ */
+void pcsample_init(void)
+{
+    clock_timer6a_init();
+    clock_start_timer(PCSAMPLE_TIMER);
+}
+
+/**
+ * @brief Stores one sample (tail called from PCSAMPLE_HANDLER, which supplies the stacked PC)
+ *
+ * @param pc The interrupted program counter
+ */
+void pcsample_record(uint32_t pc)
+{
+    // Clear the interrupt flag
+    clock_clear_interrupt(PCSAMPLE_TIMER);
+
+    if ((head - tail) >= PCSAMPLE_RING_SIZE)
+    {
+        dropped++;
+        return;
+    }
+
+    ring[head & PCSAMPLE_RING_MASK] = pc;
+    head++;
+}
+
+/**
+ * @brief Pauses or resumes sampling (the 'P' debug command)
+ */
+void pcsample_toggle(void)
+{
+    if (clock_active(PCSAMPLE_TIMER))
+    {
+        clock_stop_timer(PCSAMPLE_TIMER);
+    }
+    else
+    {
+        clock_start_timer(PCSAMPLE_TIMER);
+    }
+}
+
+/**
+ * @brief Writes one piece of the binary dump (a debug port writer): the header first, then up to
+ *        PCSAMPLE_SAMPLES_PER_WRITE samples at a time. Samples are removed from the ring as they are sent
+ *
+ * @param index Piece number
+ * @param p_buffer Storage for the piece
+ * @param size Size of the buffer
+ * @return The piece length (0 once the dump is done)
+ */
+uint8_t pcsample_write_dump(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    uint16_t count = 0;
+
+    if (index == 0)
+    {
+        // Only the samples already in the ring are sent, so the dump ends
+        uint32_t available = head - tail;
+        uint32_t lost      = dropped;
+        uint32_t period    = TIMER_6A_PERIOD + 1;
+
+        dump_remaining = (uint16_t) available;
+
+        p_buffer[0] = 'P';
+        p_buffer[1] = 'C';
+        p_buffer[2] = 'S';
+        p_buffer[3] = PCSAMPLE_FORMAT_VERSION;
+        memcpy(&p_buffer[4],  &dump_remaining, sizeof(uint16_t));
+        memset(&p_buffer[6],  0,               sizeof(uint16_t));
+        memcpy(&p_buffer[8],  &lost,           sizeof(uint32_t));
+        memcpy(&p_buffer[12], &period,         sizeof(uint32_t));
+        return PCSAMPLE_HEADER_SIZE;
+    }
+
+    count = dump_remaining;
+    if (count > PCSAMPLE_SAMPLES_PER_WRITE)
+    {
+        count = PCSAMPLE_SAMPLES_PER_WRITE;
+    }
+    if ((count * sizeof(uint32_t)) > size)
+    {
+        count = size / sizeof(uint32_t);
+    }
+
+    uint16_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        memcpy(&p_buffer[i * sizeof(uint32_t)], &ring[tail & PCSAMPLE_RING_MASK], sizeof(uint32_t));
+        tail++;
+    }
+    dump_remaining -= count;
+
+    return count * sizeof(uint32_t);
+}
+
+/* Interrupts */
+
+// PCSAMPLE_HANDLER: the hardware stacked r0-r3, r12, lr, pc, xpsr on the stack in use (bit 2 of the
+// EXC_RETURN in lr says which), so the PC is 24 bytes up. lr is left as is, so pcsample_record() returns
+// straight from the exception
+__asm("        .sect   \".text:TIMER6A_IRQHandler\"\n"
+      "        .thumb\n"
+      "        .thumbfunc TIMER6A_IRQHandler\n"
+      "        .global TIMER6A_IRQHandler\n"
+      "        .global pcsample_record\n"
+      "TIMER6A_IRQHandler:\n"
+      "        tst     lr, #4\n"
+      "        ite     eq\n"
+      "        mrseq   r0, msp\n"
+      "        mrsne   r0, psp\n"
+      "        ldr     r0, [r0, #24]\n"
+      "        b.w     pcsample_record\n");
+
+/* End pcsample.c */
@@ -0,0 +1,53 @@
+/**
+ * @file pcsample.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Statistical profiler that samples the interrupted program counter
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef PCSAMPLE_H_
+#define PCSAMPLE_H_
+
+// Note on PC sampling (enabled with PC_SAMPLING in utils.h):
+//  - PCSAMPLE_TIMER interrupts about once per ms at the highest priority. Its handler (an assembly stub in
+//      pcsample.c, so the compiler's prologue does not move the stack) reads the PC that the hardware stacked
+//      on entry, i.e., wherever the CPU was: the main loop, or a lower priority handler
+//  - Handlers at the same priority cannot be sampled. The UART handlers run just below it
+//      (UART_INTERRUPT_PRIORITY), but the switch edge handlers (SWITCH_EDGE_PRIORITY) stay at 0 so an E-stop
+//      is never delayed, and are a blind spot
+//  - The timer period is not a multiple of the other timers' periods, so the samples do not lock to them
+//  - Samples go into a single-producer (PCSAMPLE_HANDLER), single-consumer (debug port) ring. Samples that
+//      find the ring full are counted as dropped
+//  - The DEBUG_PORT 'p' command drains the ring in binary ('P' pauses/resumes sampling):
+//      - Header (PCSAMPLE_HEADER_SIZE bytes): "PCS", PCSAMPLE_FORMAT_VERSION, sample count (uint16_t),
+//          reserved (uint16_t), samples dropped so far (uint32_t), and the sample period (uint32_t, cycles)
+//      - Then count PCs (uint32_t each), oldest first. Everything is little-endian
+//  - tools/pcsample_profile.py maps each PC to a function with the .out file (nm, addr2line) and prints a flat
+//      profile
+//  - Overhead is roughly 30 cycles per sample (~0.03% of the CPU)
+
+#include "msp.h"
+#include "clock.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General sampler defines
+#define PCSAMPLE_TIMER                      (TIMER6)
+#define PCSAMPLE_HANDLER                    TIMER6A_IRQHandler          // Defined in assembly (no parentheses)
+#define PCSAMPLE_RING_SIZE                  (512)       // Must be a power of two
+#define PCSAMPLE_RING_MASK                  (PCSAMPLE_RING_SIZE - 1)
+#define PCSAMPLE_FORMAT_VERSION             (1)
+#define PCSAMPLE_HEADER_SIZE                (16)
+#define PCSAMPLE_SAMPLES_PER_WRITE          (14)
+
+// Public functions
+void pcsample_init(void);
+void pcsample_record(uint32_t pc);
+void pcsample_toggle(void);
+uint8_t pcsample_write_dump(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+#endif /* PCSAMPLE_H_ */
@@ -12,62 +12,638 @@
 
 // Private functions
 static void rpi_checksum(char *data, uint8_t size);
+static bool rpi_get_baud_code(uint32_t baud_rate, uint8_t* p_code);
+static void rpi_baud_send(rpi_baud_command_t* p_baud_command);
+
+// Rates that can be negotiated, indexed by their BAUD operand code
+static const uint32_t rpi_baud_rates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+#define RPI_NUMBER_OF_BAUD_RATES            (sizeof(rpi_baud_rates) / sizeof(rpi_baud_rates[0]))
+
+// Line errors already counted when the current rate was negotiated
+static uint32_t baseline_errors = 0;
+
+// Declare the frame parsers
+static frame_parser_t rpi_parser;
+#ifdef THREE_PARTY_MODE
+static frame_parser_t user_parser;
+static frame_parser_t* p_user_parser = &user_parser;
+#endif
+
+// Private functions
+static void rpi_rx_handler(uint8_t byte);
+#ifdef THREE_PARTY_MODE
+static void rpi_user_rx_handler(uint8_t byte);
+#endif
+static bool rpi_transmit_raw(char* data, uint8_t size);
+#if RPI_LINK_VERSION >= 2
+static bool rpi_link_send_frame(uint8_t slot, uint8_t seq);
+static bool rpi_link_send_control(uint8_t instr_and_len);
+static bool rpi_link_send_held(void);
+static void rpi_link_process_ack(uint8_t ack);
+static void rpi_link_poll(void);
+#endif
+static void rpi_flush_uart(void);
+static void rpi_link_reset(void);
+static bool rpi_link_resend(void);
+static void rpi_rtt_sample(uint8_t slot);
+
+// Send window. Slot (seq % RPI_LINK_WINDOW_SIZE) holds each outstanding message as it was built (version 1)
+static char tx_window[RPI_LINK_WINDOW_SIZE][RPI_LINK_MAX_FRAME_LENGTH];
+static uint8_t tx_window_length[RPI_LINK_WINDOW_SIZE];
+static uint8_t tx_base        = 0;      // Oldest unacknowledged sequence number
+static uint8_t tx_count       = 0;      // Number of unacknowledged frames
+static bool    ack_pending    = false;  // Something was sent that rpi_get_ack() has not reported yet
+static uint32_t tx_sent_cycles[RPI_LINK_WINDOW_SIZE];   // When each message was first sent
+static bool     tx_resent[RPI_LINK_WINDOW_SIZE];        // Resent messages give ambiguous RTT samples
+static bool    syn_pending    = false;  // A LINK_SYN is unanswered, so new frames are held in the window
+
+// Round-trip time estimate (in cycles)
+static uint32_t srtt          = 0;      // Smoothed RTT
+static uint32_t rttvar        = 0;      // Smoothed mean deviation of the RTT
+static uint32_t rto           = RPI_RTO_INITIAL_CYCLES;
+static uint8_t  rto_backoff   = 0;      // Timeouts since the last clean sample (doubles the timeout each time)
+static rpi_rtt_stats_t rtt_stats = {0, 0, 0, 0, 0, 0};
+
+// Receive state. In-order frames wait here until a command takes them
+static frame_t rx_queue[RPI_LINK_RX_QUEUE_SIZE];
+static uint8_t rx_head        = 0;
+static uint8_t rx_tail        = 0;
+static uint8_t rx_expected    = 0;      // Next sequence number expected from the Pi
+static uint8_t last_rx_version = 1;     // Version of the frame last taken with rpi_get_frame()
+
+// Link statistics
+static rpi_link_stats_t link_stats = {0, 0, 0, 0, 0};
 
 /**
  * @brief Initialize the Raspberry Pi UART Tx and Rx lines
  */
 void rpi_init(void)
 {
+    // Received bytes go straight to the frame parser
+    frame_parser_init(&rpi_parser);
+    uart_set_rx_handler(RPI_UART_CHANNEL, &rpi_rx_handler);
     uart_init(RPI_UART_CHANNEL);
+
+#ifdef UART_DMA
+    // Let the uDMA move the data
+    uartdma_init(RPI_UART_CHANNEL);
+#endif
+
+    // The Pi may still hold a sequence from before the MSP was reset
+    rpi_link_reset();
+
+#ifdef THREE_PARTY_MODE
+    // The user's frames get their own parser, unless the user is on the Pi's channel
+    if (USER_CHANNEL == RPI_UART_CHANNEL)
+    {
+        p_user_parser = &rpi_parser;
+    }
+    else
+    {
+        frame_parser_init(&user_parser);
+        uart_set_rx_handler(USER_CHANNEL, &rpi_user_rx_handler);
+    }
+#endif
 }
 
 /**
- * @brief Uses UART to send data from the MSP432 to the Raspberry Pi
+ * @brief Helper function to feed the Raspberry Pi's parser (called from the UART Rx ISR)
+ *
+ * @param byte The received byte
+ */
+static void rpi_rx_handler(uint8_t byte)
+{
+#ifdef COBS_FRAMING
+    frame_parser_feed_cobs(&rpi_parser, byte);
+#else
+    frame_parser_feed(&rpi_parser, byte);
+#endif
+}
+
+#ifdef THREE_PARTY_MODE
+/**
+ * @brief Helper function to feed the user's parser (called from the UART Rx ISR)
+ *
+ * @param byte The received byte
+ */
+static void rpi_user_rx_handler(uint8_t byte)
+{
+    frame_parser_feed(&user_parser, byte);
+}
+#endif
+
+/**
+ * @brief Helper function to queue bytes on the Raspberry Pi's channel (COBS-encoded if enabled)
  *
  * @param data Character buffer to be sent
- * @param size Number of characters to transmit (unless a null-terminator is reacher)
- * @return Whether transmission was successful
+ * @param size Number of characters to transmit
+ * @return Whether every byte was queued
+ */
+static bool rpi_transmit_raw(char* data, uint8_t size)
+{
+#ifdef COBS_FRAMING
+    // Stuff the frame and send the encoded bytes instead
+    uint8_t encoded[FRAME_COBS_MAX_LENGTH(RPI_LINK_MAX_FRAME_LENGTH)];
+    size = (uint8_t) frame_cobs_encode((uint8_t*) data, size, encoded);
+    data = (char*) encoded;
+#endif
+
+#ifdef UART_DMA
+    return uartdma_transmit(RPI_UART_CHANNEL, data, size);
+#else
+    // Queue the whole frame, so a frame is never split
+    return uart_out_bytes(RPI_UART_CHANNEL, (uint8_t*) data, size);
+#endif
+}
+
+/**
+ * @brief Queues data to be sent from the MSP432 to the Raspberry Pi. Returns without waiting for the
+ *        bytes to go out; the UART Tx interrupt (or the uDMA) drains them. A version 2 link gives the
+ *        message the next sequence number and keeps it until the Pi acknowledges it
+ *
+ * @param data Character buffer to be sent, built by one of the rpi_build_*() functions
+ * @param size Number of characters to transmit (frames are binary, so zeros are sent too)
+ * @return Whether every byte was queued (false if the send window is full)
  */
 bool rpi_transmit(char* data, uint8_t size)
 {
-    bool status = true;
+    uint8_t slot = 0;
+
+    if ((size < 4) || (size > (RPI_LINK_MAX_FRAME_LENGTH - 1)))
+    {
+        return false;
+    }
 
-    // Write one byte at a time
-    int i = 0;
-    for (i = 0; (i < size) && (status) && (data[i] != '\0'); i++)
+#if RPI_LINK_VERSION >= 2
+    // Take in any ACKs first, so the window is as open as possible
+    rpi_link_poll();
+    if (tx_count >= RPI_LINK_WINDOW_SIZE)
     {
-        status &= uart_out_byte(RPI_UART_CHANNEL, (uint8_t) data[i]);
-        utils_delay(70000);
+        return false;
     }
+    slot = (tx_base + tx_count) % RPI_LINK_WINDOW_SIZE;
+#endif
 
-    return status;
+    // Keep a copy for retransmission
+    memcpy(tx_window[slot], data, size);
+    tx_window_length[slot] = size;
+    tx_sent_cycles[slot]   = utils_get_cycles();
+    tx_resent[slot]        = false;
+    ack_pending = true;
+    link_stats.frames_sent++;
+
+#if RPI_LINK_VERSION >= 2
+    tx_count++;
+
+    // The Pi has not restarted its receive sequence yet, so the frame goes out with the LINK_SYN_ACK
+    if (syn_pending)
+    {
+        return true;
+    }
+    return rpi_link_send_frame(slot, (tx_base + tx_count - 1) % RPI_LINK_SEQ_MODULUS);
+#else
+    return rpi_transmit_raw(data, size);
+#endif
 }
 
 /**
- * @brief Uses UART to read data from the the Raspberry Pi to the MSP432
+ * @brief Sends every unacknowledged message again (go-back-N), and backs off the retransmission
+ *        timeout. Call when rpi_get_rto_cycles() passes without an ACK
  *
- * @param data Character buffer to be sent
- * @param size Number of characters to transmit (unless a null-terminator is reacher)
- * @return Whether the read was successful
+ * @return Whether every byte was queued
  */
-bool rpi_receive(char *data, uint8_t size)
+bool rpi_retransmit(void)
 {
-    return uart_read_string(RPI_UART_CHANNEL, data, size);
+    if (rto_backoff < RPI_RTO_MAX_BACKOFF)
+    {
+        rto_backoff++;
+    }
+
+    return rpi_link_resend();
 }
 
+/**
+ * @brief Helper function to send every unacknowledged message again (go-back-N)
+ *
+ * @return Whether every byte was queued
+ */
+static bool rpi_link_resend(void)
+{
+    bool success = true;
+
+#if RPI_LINK_VERSION >= 2
+    uint8_t i = 0;
+
+    rpi_link_poll();
+
+    // Nothing can be sent until the Pi answers the LINK_SYN
+    if (syn_pending)
+    {
+        return rpi_link_send_control(LINK_SYN_INSTR_AND_LEN);
+    }
 
+    for (i = 0; i < tx_count; i++)
+    {
+        uint8_t seq = (tx_base + i) % RPI_LINK_SEQ_MODULUS;
+        success = rpi_link_send_frame(seq % RPI_LINK_WINDOW_SIZE, seq) && success;
+        tx_resent[seq % RPI_LINK_WINDOW_SIZE] = true;
+        link_stats.retransmits++;
+    }
+#else
+    if (tx_window_length[0] > 0)
+    {
+        success = rpi_transmit_raw(tx_window[0], tx_window_length[0]);
+        tx_resent[0] = true;
+        link_stats.retransmits++;
+    }
+#endif
+
+    return success;
+}
+
+#if RPI_LINK_VERSION >= 2
 /**
- * @brief Uses UART to read data from the the Raspberry Pi to the MSP432
+ * @brief Helper function to send a stored message as a version 2 frame
  *
- * @param data Character buffer to be sent
- * @param size Number of characters to transmit (unless a null-terminator is reacher)
- * @return Whether the read was successful
+ * @param slot The window slot holding the message
+ * @param seq The sequence number of the message
+ * @return Whether every byte was queued
+ */
+static bool rpi_link_send_frame(uint8_t slot, uint8_t seq)
+{
+    char frame[RPI_LINK_MAX_FRAME_LENGTH];
+    char* message = tx_window[slot];
+    uint8_t size  = tx_window_length[slot];
+
+    // START, INSTR/LEN, SEQ/ACK, then the operands (the message's check bytes are replaced)
+    frame[0] = START_BYTE_V2;
+    frame[1] = message[1];
+    frame[2] = (char) ((seq << 4) | rx_expected);
+    memcpy(&frame[3], &message[2], size - 4);
+    rpi_checksum(frame, size - 1);
+
+    return rpi_transmit_raw(frame, size + 1);
+}
+
+/**
+ * @brief Helper function to send a link control frame carrying the current cumulative ACK
+ *
+ * @param instr_and_len One of {LINK_ACK_INSTR_AND_LEN, LINK_NAK_INSTR_AND_LEN, LINK_SYN_INSTR_AND_LEN,
+ *  LINK_SYN_ACK_INSTR_AND_LEN}
+ * @return Whether every byte was queued
+ */
+static bool rpi_link_send_control(uint8_t instr_and_len)
+{
+    char frame[5];
+
+    frame[0] = START_BYTE_V2;
+    frame[1] = instr_and_len;
+    frame[2] = (char) rx_expected;
+    rpi_checksum(frame, 3);
+
+    return rpi_transmit_raw(frame, 5);
+}
+
+/**
+ * @brief Helper function to send the frames held back while a LINK_SYN was unanswered
+ *
+ * @return Whether every byte was queued
+ */
+static bool rpi_link_send_held(void)
+{
+    bool success = true;
+    uint8_t i = 0;
+
+    for (i = 0; i < tx_count; i++)
+    {
+        uint8_t seq = (tx_base + i) % RPI_LINK_SEQ_MODULUS;
+        tx_sent_cycles[seq % RPI_LINK_WINDOW_SIZE] = utils_get_cycles();
+        success = rpi_link_send_frame(seq % RPI_LINK_WINDOW_SIZE, seq) && success;
+    }
+
+    return success;
+}
+
+/**
+ * @brief Helper function to slide the send window up to a cumulative ACK
+ *
+ * @param ack The next sequence number the Pi expects
+ */
+static void rpi_link_process_ack(uint8_t ack)
+{
+    uint8_t acked = (ack - tx_base) & (RPI_LINK_SEQ_MODULUS - 1);
+
+    // Until the LINK_SYN is answered, every ACK belongs to the old sequence
+    if (syn_pending)
+    {
+        return;
+    }
+
+    // Anything outside the window is stale
+    if ((acked > 0) && (acked <= tx_count))
+    {
+        // The newest frame acknowledged gives the freshest sample
+        rpi_rtt_sample((tx_base + acked - 1) % RPI_LINK_WINDOW_SIZE);
+        tx_base   = (tx_base + acked) % RPI_LINK_SEQ_MODULUS;
+        tx_count -= acked;
+    }
+}
+
+/**
+ * @brief Helper function to handle everything the parser has validated: slide the send window, answer
+ *        NAKs, and acknowledge (or reject) data frames
+ */
+static void rpi_link_poll(void)
+{
+    frame_t frame;
+
+    while (frame_parser_pop(&rpi_parser, &frame))
+    {
+        uint8_t next_rx_head = (rx_head + 1) % RPI_LINK_RX_QUEUE_SIZE;
+
+        // A version 1 frame is passed on as is (it is ACKed with rpi_transmit_ack())
+        if (frame.version < 2)
+        {
+            if (next_rx_head != rx_tail)
+            {
+                rx_queue[rx_head] = frame;
+                rx_head = next_rx_head;
+            }
+            continue;
+        }
+
+        // Every version 2 frame carries a cumulative ACK
+        rpi_link_process_ack(frame.ack);
+
+        if (frame.instruction == LINK_ACK_INSTR)
+        {
+            continue;
+        }
+        if (frame.instruction == LINK_NAK_INSTR)
+        {
+            // Resend everything past the ACK right away
+            link_stats.naks_received++;
+            rpi_link_resend();
+            continue;
+        }
+        if (frame.instruction == LINK_SYN_INSTR)
+        {
+            // The Pi restarted its send sequence
+            rx_expected = 0;
+            rpi_link_send_control(LINK_SYN_ACK_INSTR_AND_LEN);
+            continue;
+        }
+        if (frame.instruction == LINK_SYN_ACK_INSTR)
+        {
+            // The Pi restarted its receive sequence, so the held frames can go
+            if (syn_pending)
+            {
+                syn_pending = false;
+                rpi_link_send_held();
+            }
+            continue;
+        }
+
+        // Data frame. Deliver it only if it is the next one, and there is room (otherwise the Pi resends)
+        if (frame.seq == rx_expected)
+        {
+            if (next_rx_head == rx_tail)
+            {
+                continue;
+            }
+            rx_queue[rx_head] = frame;
+            rx_head = next_rx_head;
+            rx_expected = (rx_expected + 1) % RPI_LINK_SEQ_MODULUS;
+            rpi_link_send_control(LINK_ACK_INSTR_AND_LEN);
+        }
+        else if (((rx_expected - frame.seq) & (RPI_LINK_SEQ_MODULUS - 1)) <= RPI_LINK_WINDOW_SIZE)
+        {
+            // Already delivered, so the ACK was lost
+            link_stats.duplicates++;
+            rpi_link_send_control(LINK_ACK_INSTR_AND_LEN);
+        }
+        else
+        {
+            // A frame went missing
+            link_stats.naks_sent++;
+            rpi_link_send_control(LINK_NAK_INSTR_AND_LEN);
+        }
+    }
+}
+#endif
+
+/**
+ * @brief Helper function to clear the Tx and Rx fifos and any partly received frame. Frames the parser
+ *        already validated, and the link state, are kept
+ */
+static void rpi_flush_uart(void)
+{
+    uart_reset(RPI_UART_CHANNEL);
+#ifdef UART_DMA
+    uartdma_reset(RPI_UART_CHANNEL);
+#endif
+    frame_parser_resync(&rpi_parser);
+}
+
+/**
+ * @brief Helper function to restart the send sequence and drop anything outstanding. A version 2 link
+ *        tells the Pi with a LINK_SYN, and holds new frames until the Pi answers it
  */
-bool rpi_receive_unblocked(char *data, uint8_t size)
+static void rpi_link_reset(void)
 {
-    return uart_read_string_unblocked(RPI_UART_CHANNEL, data, size);
+    tx_base     = 0;
+    tx_count    = 0;
+    ack_pending = false;
+    rx_head     = 0;
+    rx_tail     = 0;
+    tx_window_length[0] = 0;
+
+    // A new link starts without backoff, but the RTT estimate is kept
+    rto_backoff = 0;
+
+#if RPI_LINK_VERSION >= 2
+    syn_pending = true;
+    rpi_link_send_control(LINK_SYN_INSTR_AND_LEN);
+#endif
 }
 
+/**
+ * @brief Helper function to fold a round-trip time sample into the estimate (Jacobson/Karels, as in RFC 6298)
+ *
+ * @param slot The window slot of the acknowledged message
+ */
+static void rpi_rtt_sample(uint8_t slot)
+{
+    uint32_t sample = utils_get_cycles() - tx_sent_cycles[slot];
+    uint32_t error  = 0;
+
+    // Karn's rule: an ACK for a resent message could belong to either copy
+    if (tx_resent[slot])
+    {
+        return;
+    }
+
+    if (rtt_stats.samples == 0)
+    {
+        srtt   = sample;
+        rttvar = sample / 2;
+        rtt_stats.min_us = 0xFFFFFFFF;
+    }
+    else
+    {
+        // rttvar += (|srtt - sample| - rttvar) / 4, srtt += (sample - srtt) / 8
+        error  = (srtt > sample) ? (srtt - sample) : (sample - srtt);
+        rttvar = rttvar - (rttvar >> 2) + (error >> 2);
+        srtt   = srtt - (srtt >> 3) + (sample >> 3);
+    }
+
+    // Timeout = srtt + 4*rttvar, within limits
+    rto = srtt + (rttvar << 2);
+    if (rto < RPI_RTO_MIN_CYCLES)
+    {
+        rto = RPI_RTO_MIN_CYCLES;
+    }
+    else if (rto > RPI_RTO_MAX_CYCLES)
+    {
+        rto = RPI_RTO_MAX_CYCLES;
+    }
+
+    // A clean sample means the link is healthy again
+    rto_backoff = 0;
+
+    // Statistics
+    rtt_stats.samples++;
+    rtt_stats.last_us   = sample / RPI_CYCLES_PER_US;
+    rtt_stats.srtt_us   = srtt / RPI_CYCLES_PER_US;
+    rtt_stats.rttvar_us = rttvar / RPI_CYCLES_PER_US;
+    if (rtt_stats.last_us < rtt_stats.min_us)
+    {
+        rtt_stats.min_us = rtt_stats.last_us;
+    }
+    if (rtt_stats.last_us > rtt_stats.max_us)
+    {
+        rtt_stats.max_us = rtt_stats.last_us;
+    }
+}
+
+/**
+ * @brief Gets the retransmission timeout, including any backoff
+ *
+ * @return The timeout in cycles
+ */
+uint32_t rpi_get_rto_cycles(void)
+{
+    uint32_t timeout = rto;
+    uint8_t i = 0;
+
+    for (i = 0; (i < rto_backoff) && (timeout < RPI_RTO_MAX_CYCLES); i++)
+    {
+        timeout <<= 1;
+    }
+
+    return (timeout < RPI_RTO_MAX_CYCLES) ? timeout : RPI_RTO_MAX_CYCLES;
+}
+
+/**
+ * @brief Gets the round-trip time statistics
+ *
+ * @return A copy of the statistics
+ */
+rpi_rtt_stats_t rpi_get_rtt_stats(void)
+{
+    return rtt_stats;
+}
+
+/**
+ * @brief Gets the oldest validated frame from the Raspberry Pi, without blocking
+ *
+ * @param p_frame Storage for the frame
+ * @return Whether a frame was available
+ */
+bool rpi_get_frame(frame_t* p_frame)
+{
+#if RPI_LINK_VERSION >= 2
+    rpi_link_poll();
+#else
+    frame_t frame;
+    uint8_t next_rx_head = (rx_head + 1) % RPI_LINK_RX_QUEUE_SIZE;
+
+    if ((next_rx_head != rx_tail) && frame_parser_pop(&rpi_parser, &frame))
+    {
+        rx_queue[rx_head] = frame;
+        rx_head = next_rx_head;
+    }
+#endif
+
+    if (rx_tail == rx_head)
+    {
+        return false;
+    }
+
+    *p_frame = rx_queue[rx_tail];
+    rx_tail = (rx_tail + 1) % RPI_LINK_RX_QUEUE_SIZE;
+    last_rx_version = p_frame->version;
+    return true;
+}
+
+/**
+ * @brief Checks for an ACK from the Raspberry Pi, without blocking. On a version 2 link, this is once
+ *        everything sent so far has been acknowledged
+ *
+ * @return Whether an ACK was received (each ACK is only reported once)
+ */
+bool rpi_get_ack(void)
+{
+#if RPI_LINK_VERSION >= 2
+    rpi_link_poll();
+    if (ack_pending && (tx_count == 0))
+    {
+        ack_pending = false;
+        return true;
+    }
+    return false;
+#else
+    if (!frame_parser_take_ack(&rpi_parser))
+    {
+        return false;
+    }
+    rpi_rtt_sample(0);
+    return true;
+#endif
+}
+
+/**
+ * @brief Gets the link statistics
+ *
+ * @return A copy of the statistics
+ */
+rpi_link_stats_t rpi_get_link_stats(void)
+{
+    return link_stats;
+}
+
+#ifdef THREE_PARTY_MODE
+/**
+ * @brief Gets the oldest validated frame from the user, without blocking
+ *
+ * @param p_frame Storage for the frame
+ * @return Whether a frame was available
+ */
+bool rpi_get_user_frame(frame_t* p_frame)
+{
+    return frame_parser_pop(p_user_parser, p_frame);
+}
+
+/**
+ * @brief Clears the user's fifos and any partly received frame
+ */
+void rpi_reset_user_uart(void)
+{
+    uart_reset(USER_CHANNEL);
+    frame_parser_reset(p_user_parser);
+}
+#endif
+
 /**
  * @brief Attaches a checksum to a UART message
  * 
@@ -147,15 +723,42 @@ bool rpi_build_human_move_msg(char move[5], char message[HUMAN_MOVE_INSTR_LENGTH
  */
 bool rpi_transmit_ack(void)
 {
-    return uart_out_byte(RPI_UART_CHANNEL, (uint8_t) ACK_BYTE);
+    char ack_byte = ACK_BYTE;
+
+    // A version 2 frame was already acknowledged by the link
+    if (last_rx_version >= 2)
+    {
+        return true;
+    }
+    return rpi_transmit_raw(&ack_byte, 1);
 }
 
 /**
- * @brief Clears the Tx and Rx fifos for RPi communication
+ * @brief Clears the Tx and Rx fifos for RPi communication, and any partly received frame, then restarts
+ *        the link's send sequence (e.g., for a new game)
  */
 void rpi_reset_uart(void)
 {
-    uart_reset(RPI_UART_CHANNEL);
+    rpi_flush_uart();
+    frame_parser_reset(&rpi_parser);
+    rpi_link_reset();
+}
+
+/**
+ * @brief Checks whether the link has seen too many errors since its rate was negotiated. The caller falls
+ *        back with a BAUD exchange (see rpi_baud_build_command()) while no reply is expected, so the Pi
+ *        hears the request and switches too
+ *
+ * @return true if the link should fall back to the default rate
+ */
+bool rpi_check_link_errors(void)
+{
+    if (uart_get_baud_rate(RPI_UART_CHANNEL) == RPI_DEFAULT_BAUD_RATE)
+    {
+        return false;
+    }
+
+    return ((uart_get_error_count(RPI_UART_CHANNEL) - baseline_errors) > RPI_BAUD_MAX_ERRORS);
 }
 
 /**
@@ -222,4 +825,180 @@ chess_move_t rpi_castle_get_rook_move(chess_move_t *p_king_move)
     return rook_move;
 }
 
+/* Command Functions */
+
+/**
+ * @brief Helper function to find the BAUD operand code of a rate
+ *
+ * @param baud_rate The rate to look up
+ * @param p_code Storage for the code
+ * @return Whether the rate can be negotiated
+ */
+static bool rpi_get_baud_code(uint32_t baud_rate, uint8_t* p_code)
+{
+    uint8_t i = 0;
+    for (i = 0; i < RPI_NUMBER_OF_BAUD_RATES; i++)
+    {
+        if (rpi_baud_rates[i] == baud_rate)
+        {
+            *p_code = i;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Helper function to (re)send the BAUD message and restart the ACK timeout
+ *
+ * @param p_baud_command The baud command being run
+ */
+static void rpi_baud_send(rpi_baud_command_t* p_baud_command)
+{
+    // The first attempt at each rate is a new message, later attempts resend it. The negotiation has its own
+    // timeout, so its resends leave the RTO backoff of the message traffic alone
+    if (p_baud_command->attempts == 0)
+    {
+        rpi_transmit(p_baud_command->message, BAUD_INSTR_LENGTH);
+    }
+    else
+    {
+        rpi_link_resend();
+    }
+    p_baud_command->sent_cycles = utils_get_cycles();
+    p_baud_command->attempts++;
+}
+
+/**
+ * @brief Build a baud rate negotiation command
+ *
+ * @param baud_rate The rate to move the link to
+ * @returns Pointer to the dynamically-allocated command
+ */
+rpi_baud_command_t* rpi_baud_build_command(uint32_t baud_rate)
+{
+    // The thing to return
+    rpi_baud_command_t* p_command = (rpi_baud_command_t*) memstats_malloc(sizeof(rpi_baud_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
+
+    // Functions
+    p_command->command.p_entry   = &rpi_baud_entry;
+    p_command->command.p_action  = &rpi_baud_action;
+    p_command->command.p_exit    = &utils_empty_function;
+    p_command->command.p_is_done = &rpi_baud_is_done;
+
+    // Data
+    p_command->baud_rate   = baud_rate;
+    p_command->state       = BAUD_REQUEST;
+    p_command->attempts    = 0;
+    p_command->sent_cycles = 0;
+
+    return p_command;
+}
+
+/**
+ * @brief Builds the BAUD message and sends the request at the current rate
+ *
+ * @param command The baud command being run
+ */
+void rpi_baud_entry(command_t* command)
+{
+    rpi_baud_command_t* p_baud_command = (rpi_baud_command_t*) command;
+    uint8_t code = 0;
+
+    // Nothing to do if the rate is unsupported or already in use
+    if ((!rpi_get_baud_code(p_baud_command->baud_rate, &code)) ||
+        (uart_get_baud_rate(RPI_UART_CHANNEL) == p_baud_command->baud_rate))
+    {
+        p_baud_command->state = BAUD_DONE;
+        return;
+    }
+
+    // Build the message
+    p_baud_command->message[0] = START_BYTE;
+    p_baud_command->message[1] = BAUD_INSTR_AND_LEN;
+    p_baud_command->message[2] = code;
+    rpi_checksum(p_baud_command->message, BAUD_INSTR_LENGTH-2);
+
+    // Ask at the current rate
+    rpi_flush_uart();
+    p_baud_command->state    = BAUD_REQUEST;
+    p_baud_command->attempts = 0;
+    rpi_baud_send(p_baud_command);
+}
+
+/**
+ * @brief Waits for each ACK, switching rates after the request and falling back if verification fails
+ *
+ * @param command The baud command being run
+ */
+void rpi_baud_action(command_t* command)
+{
+    rpi_baud_command_t* p_baud_command = (rpi_baud_command_t*) command;
+    if (p_baud_command->state == BAUD_DONE)
+    {
+        return;
+    }
+
+    // Handle an ACK
+    if (rpi_get_ack())
+    {
+        if (p_baud_command->state == BAUD_REQUEST)
+        {
+            // The Pi agreed, switch and confirm at the new rate
+            uart_set_baud_rate(RPI_UART_CHANNEL, p_baud_command->baud_rate);
+            rpi_flush_uart();
+            p_baud_command->state    = BAUD_VERIFY;
+            p_baud_command->attempts = 0;
+            rpi_baud_send(p_baud_command);
+        }
+        else
+        {
+            // The link works at the new rate
+            baseline_errors       = uart_get_error_count(RPI_UART_CHANNEL);
+            p_baud_command->state = BAUD_DONE;
+        }
+        return;
+    }
+
+    // Retry on timeout, giving up after too many attempts
+    if ((utils_get_cycles() - p_baud_command->sent_cycles) < RPI_BAUD_TIMEOUT_CYCLES)
+    {
+        return;
+    }
+
+    if (p_baud_command->attempts < RPI_BAUD_MAX_ATTEMPTS)
+    {
+        rpi_baud_send(p_baud_command);
+    }
+    else
+    {
+        // Stay at (or return to) the default rate
+        if (p_baud_command->state == BAUD_VERIFY)
+        {
+            uart_set_baud_rate(RPI_UART_CHANNEL, RPI_DEFAULT_BAUD_RATE);
+            rpi_flush_uart();
+        }
+        baseline_errors       = uart_get_error_count(RPI_UART_CHANNEL);
+        p_baud_command->state = BAUD_DONE;
+    }
+}
+
+/**
+ * @brief Done once the rate is settled (negotiated or fallen back), or on a reset
+ *
+ * @param command The baud command being run
+ * @return Whether the negotiation is over
+ */
+bool rpi_baud_is_done(command_t* command)
+{
+    rpi_baud_command_t* p_baud_command = (rpi_baud_command_t*) command;
+
+    return ((p_baud_command->state == BAUD_DONE) || sys_reset || sys_limit);
+}
+
 /* End raspberrypi.c */
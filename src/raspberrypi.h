@@ -14,11 +14,14 @@
 #include "msp.h"
 #include "clock.h"
 #include "command_queue.h"
+#include "frame.h"
 #include "gpio.h"
 #include "uart.h"
+#include "uartdma.h"
 #include "utils.h"
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
 
 // General Raspberry Pi defines
 #define USER_CHANNEL                        (UART_CHANNEL_0)
@@ -29,15 +32,74 @@
 #   define RPI_UART_CHANNEL                 (UART_CHANNEL_3)
 #endif
 
+// Note on transmitting:
+//  - rpi_transmit() only queues a frame. The UART Tx interrupt moves it into the hardware FIFO, so the
+//      caller (e.g., gantry_comm_entry()) returns immediately
+//  - Pacing is credit-based with a single credit: a frame is not followed by the next one until the Pi ACKs
+//      it (or the comm timer retransmits it), so the Pi never has more than one frame to absorb
+//  - RTS/CTS is not used. UART3's RTS/CTS pins (PP4/PP5 or PN4/PN5) drive the Z stepper on this board
+
+// Note on receiving:
+//  - Received bytes never sit in the UART software FIFO. The Rx ISR feeds them to a frame parser (frame.h)
+//  - Commands poll rpi_get_frame() and rpi_get_ack(), which return immediately
+//  - In THREE_PARTY_MODE, USER_CHANNEL gets its own parser (shared with the Pi's if they are the same channel)
+
 // UART instructions are defined as:
 //  - 1 start byte (0x0A)
 //  - 1 byte containing the instruction ID (4 bits) and the operand length in bytes (4 bits)
 //  - 0 - 5 bytes containing the operand
 //  - 2 bytes containing the check bytes for the instruction
 
-// Start byte + ACK signal
-#define START_BYTE                          (0x0A)
-#define ACK_BYTE                            (0x0F)
+// Note on the link versions:
+//  - Version 1 (START_BYTE): stop-and-wait. Each frame is answered with a lone ACK_BYTE, and a lost frame or
+//      ACK is only recovered when the comm timer retransmits
+//  - Version 2 (START_BYTE_V2): sliding window. A SEQ/ACK byte follows the instruction byte
+//      - High nibble: sequence number of the frame (mod RPI_LINK_SEQ_MODULUS). LINK_* control frames use 0
+//      - Low nibble: cumulative ACK, the next sequence number the sender expects (every frame carries one)
+//      - Up to RPI_LINK_WINDOW_SIZE data frames may be unacknowledged, so telemetry can be pipelined with
+//          game traffic
+//      - The receiver answers an in-order frame with LINK_ACK, a duplicate with LINK_ACK (re-sent), and a
+//          gap with LINK_NAK. A NAK makes the sender resend everything unacknowledged right away (go-back-N)
+//      - Both sides start at sequence number 0. A side that restarts its send sequence (the MSP does on
+//          rpi_init() and rpi_reset_uart(), e.g., for a new game) sends LINK_SYN, and holds its data frames
+//          until the other side answers with LINK_SYN_ACK. The receiver of a LINK_SYN restarts its
+//          expected sequence number at 0. A lost LINK_SYN is resent by the comm timer like a data frame
+//      - Changing the baud rate does not touch the sequence numbers, so BAUD at the new rate carries the
+//          next sequence number as usual
+//  - RPI_LINK_VERSION picks what the MSP sends. It is 1 unless SLIDING_WINDOW_LINK is defined in utils.h,
+//      since a Pi that only speaks version 1 never sees a START_BYTE otherwise. Version 1 frames from the
+//      Pi are always accepted
+//  - The retransmission timeout adapts to the link. Each ACK times its message with the cycle counter, and
+//      the timeout is the smoothed RTT plus four mean deviations (RFC 6298). Resent messages are not timed,
+//      and every timeout doubles the next one until a clean sample arrives
+//  - A version 1 frame has no sequence number, so the Pi cannot tell a resend from a new message (e.g., a
+//      second HUMAN_MOVE). The version 1 timeout never drops below RPI_RTO_MIN_CYCLES (seconds), so a slow
+//      ACK is not mistaken for a lost one. The 20ms minimum only applies to version 2, which drops duplicates
+
+// Start bytes + ACK signal (START_BYTE, START_BYTE_V2, ACK_BYTE) are defined in frame.h
+
+// Link defines
+#ifdef SLIDING_WINDOW_LINK
+#   define RPI_LINK_VERSION                 (2)
+#else
+#   define RPI_LINK_VERSION                 (1)
+#endif
+#define RPI_LINK_SEQ_MODULUS                (16)        // 4-bit sequence numbers
+#define RPI_LINK_WINDOW_SIZE                (4)         // Must divide RPI_LINK_SEQ_MODULUS
+#define RPI_LINK_RX_QUEUE_SIZE              (4)
+#define RPI_LINK_MAX_FRAME_LENGTH           (3 + FRAME_MAX_OPERANDS + 2)
+
+// Retransmission timeout defines
+#define RPI_CYCLES_PER_US                   (SYSCLOCK_FREQUENCY / 1000000)
+#if RPI_LINK_VERSION >= 2
+#   define RPI_RTO_INITIAL_CYCLES           (SYSCLOCK_FREQUENCY / 2)    // 500ms until the first RTT sample
+#   define RPI_RTO_MIN_CYCLES               (SYSCLOCK_FREQUENCY / 50)   // 20ms, covers a frame each way at 9600 baud
+#else
+#   define RPI_RTO_INITIAL_CYCLES           (SYSCLOCK_FREQUENCY * 2)    // 2s, same as the minimum
+#   define RPI_RTO_MIN_CYCLES               (SYSCLOCK_FREQUENCY * 2)    // 2s, a version 1 resend is not idempotent
+#endif
+#define RPI_RTO_MAX_CYCLES                  (SYSCLOCK_FREQUENCY * 5)    // 5s, the old fixed timeout
+#define RPI_RTO_MAX_BACKOFF                 (8)
 
 // Individual instruction IDs
 #define RESET_INSTR                         (0x00)
@@ -46,6 +108,11 @@
 #define HUMAN_MOVE_INSTR                    (0x03)
 #define ROBOT_MOVE_INSTR                    (0x04)
 #define ILLEGAL_MOVE_INSTR                  (0x05)
+#define BAUD_INSTR                          (0x06)
+#define LINK_ACK_INSTR                      (0x07)
+#define LINK_NAK_INSTR                      (0x08)
+#define LINK_SYN_INSTR                      (0x09)
+#define LINK_SYN_ACK_INSTR                  (0x0A)
 
 // Instruction and operand length bytes
 #define RESET_INSTR_AND_LEN                 (0x00)
@@ -54,6 +121,11 @@
 #define HUMAN_MOVE_INSTR_AND_LEN            (0x35)
 #define ROBOT_MOVE_INSTR_AND_LEN            (0x46)
 #define ILLEGAL_MOVE_INSTR_AND_LEN          (0x50)
+#define BAUD_INSTR_AND_LEN                  (0x61)
+#define LINK_ACK_INSTR_AND_LEN              (0x70)
+#define LINK_NAK_INSTR_AND_LEN              (0x80)
+#define LINK_SYN_INSTR_AND_LEN              (0x90)
+#define LINK_SYN_ACK_INSTR_AND_LEN          (0xA0)
 
 // Full Instructions/Operations
 #define RESET                               (0x0A00)             // Reset a terminated game
@@ -62,6 +134,7 @@
 #define HUMAN_MOVE                          (0x0A35000000000000) // 5 operand bytes for UCI representation of move (fill in trailing zeroes with move)
 #define ROBOT_MOVE                          (0x0A46000000000000) // 5 operand bytes for UCI representation of move (fill in trailing zeroes with move)
 #define ILLEGAL_MOVE                        (0x0A50)             // Declare the human has made an illegal move
+#define BAUD                                (0x0A6100)           // 1 operand byte for the requested baud rate code
 
 // Game status codes
 #define GAME_ONGOING                        (0x01)
@@ -72,6 +145,24 @@
 #define START_INSTR_LENGTH                   (4)
 #define RESET_INSTR_LENGTH                   (4)
 #define HUMAN_MOVE_INSTR_LENGTH              (9)
+#define BAUD_INSTR_LENGTH                    (5)
+
+// Baud rate negotiation
+// - The link always starts at RPI_DEFAULT_BAUD_RATE
+// - The MSP sends BAUD with the code of the requested rate (index into the rate table in raspberrypi.c)
+// - The Pi ACKs at the old rate, then both sides switch
+// - The MSP repeats BAUD at the new rate. The Pi's ACK confirms the link; if none arrives, the MSP falls
+//      back to the default rate (the Pi should do the same if it hears nothing valid at the new rate)
+// - Too many line errors at the negotiated rate also fall back to the default rate, with the same exchange
+//      (BAUD with the default rate's code). It is queued just before the MSP's next message (HUMAN_MOVE or
+//      START), when the Pi is waiting on the MSP and no reply is in flight. If the request itself goes
+//      unanswered, both sides stay where they are
+// - Changing rates only drops partly received bytes. Frames the parser already validated are kept
+#define RPI_DEFAULT_BAUD_RATE               (UART_DEFAULT_BAUD_RATE)
+#define RPI_NEGOTIATED_BAUD_RATE            (115200)
+#define RPI_BAUD_TIMEOUT_CYCLES             (SYSCLOCK_FREQUENCY / 10)   // 100ms to wait for each ACK
+#define RPI_BAUD_MAX_ATTEMPTS               (5)
+#define RPI_BAUD_MAX_ERRORS                 (4)                         // Line errors before falling back
 
 // Information from the PI for making a chess move
 // Use '\0' for undefined file and 0 for undefined rank
@@ -90,12 +181,57 @@ typedef enum game_status_t {
     STALEMATE
 } game_status_t;
 
+// Round-trip time statistics (microseconds)
+typedef struct rpi_rtt_stats_t {
+    uint32_t samples;                   // ACKs timed (resent messages are not timed)
+    uint32_t last_us;
+    uint32_t srtt_us;                   // Smoothed RTT
+    uint32_t rttvar_us;                 // Smoothed mean deviation
+    uint32_t min_us;
+    uint32_t max_us;
+} rpi_rtt_stats_t;
+
+// Link statistics
+typedef struct rpi_link_stats_t {
+    uint32_t frames_sent;               // New data frames (not counting retransmissions)
+    uint32_t retransmits;               // Frames sent again (timeout or NAK)
+    uint32_t naks_received;
+    uint32_t naks_sent;
+    uint32_t duplicates;                // Frames received again (e.g., after a lost ACK)
+} rpi_link_stats_t;
+
+// Baud rate negotiation states
+typedef enum rpi_baud_state_t {
+    BAUD_REQUEST,               // Asking at the old rate
+    BAUD_VERIFY,                // Confirming at the new rate
+    BAUD_DONE,
+} rpi_baud_state_t;
+
+// Command to negotiate the baud rate
+typedef struct rpi_baud_command_t {
+    command_t command;
+    uint32_t baud_rate;                 // The rate being negotiated
+    rpi_baud_state_t state;
+    uint8_t attempts;                   // Transmissions in the current state
+    uint32_t sent_cycles;               // Cycle count of the last transmission
+    char message[BAUD_INSTR_LENGTH];
+} rpi_baud_command_t;
+
 // Public functions
 void rpi_init(void);
 bool rpi_transmit(char* data, uint8_t size);
-bool rpi_receive(char *data, uint8_t size);
-bool rpi_receive_unblocked(char *data, uint8_t size);
+bool rpi_retransmit(void);
+bool rpi_get_frame(frame_t* p_frame);
+bool rpi_get_ack(void);
 void rpi_reset_uart(void);
+#ifdef THREE_PARTY_MODE
+bool rpi_get_user_frame(frame_t* p_frame);
+void rpi_reset_user_uart(void);
+#endif
+bool rpi_check_link_errors(void);
+rpi_link_stats_t rpi_get_link_stats(void);
+uint32_t rpi_get_rto_cycles(void);
+rpi_rtt_stats_t rpi_get_rtt_stats(void);
 
 // Raspberry Pi instruction functions
 char* rpi_build_reset_msg(char message[RESET_INSTR_LENGTH]);
@@ -104,4 +240,10 @@ bool rpi_build_human_move_msg(char move[5], char message[HUMAN_MOVE_INSTR_LENGTH
 bool rpi_transmit_ack(void);
 chess_move_t rpi_castle_get_rook_move(chess_move_t *king_move);
 
+// Command Functions (negotiating the baud rate)
+rpi_baud_command_t* rpi_baud_build_command(uint32_t baud_rate);
+void rpi_baud_entry(command_t* command);
+void rpi_baud_action(command_t* command);
+bool rpi_baud_is_done(command_t* command);
+
 #endif /* RASPBERRYPI_H_ */
@@ -0,0 +1,338 @@
+/**
+ * @file replay.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Replays a recorded game with the robot and times every move
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "replay.h"
+#include "gantry.h"
+#include <stdio.h>
+#include <string.h>
+
+// Private functions
+static void replay_snapshot(replay_result_t* p_totals);
+static bool replay_is_valid_move(const char* p_move);
+
+// The recorded game (Italian game, both sides castle, then a run of captures on d4)
+static const char replay_moves[][REPLAY_MOVE_LENGTH] = {
+    {'e','2','e','4','_'}, {'e','7','e','5','_'},
+    {'g','1','f','3','_'}, {'b','8','c','6','_'},
+    {'f','1','c','4','_'}, {'f','8','c','5','_'},
+    {'e','1','g','1','c'}, {'g','8','f','6','_'},
+    {'d','2','d','4','_'}, {'e','5','d','4','C'},
+    {'f','3','d','4','C'}, {'c','6','d','4','C'},
+    {'d','1','d','4','C'}, {'c','5','d','4','C'},
+    {'e','8','g','8','c'},
+};
+#define NUMBER_OF_REPLAY_PLIES              (sizeof(replay_moves) / sizeof(replay_moves[0]))
+
+// The game loaded over the debug port (used instead of replay_moves[] unless empty)
+static char loaded_moves[REPLAY_MAX_PLIES][REPLAY_MOVE_LENGTH];
+static uint16_t loaded_plies        = 0;
+static const char* p_load_error     = 0;            // Why the last line was dropped (0 if it was not)
+
+// Game being replayed
+static const char (*p_game)[REPLAY_MOVE_LENGTH] = replay_moves;
+static uint16_t game_plies          = NUMBER_OF_REPLAY_PLIES;
+static bool replay_running          = false;
+
+// Declare the results (written by replay commands, read by the debug port)
+static replay_result_t results[REPLAY_MAX_PLIES];
+static volatile uint16_t plies_done = 0;
+static volatile bool game_done      = false;
+static uint32_t game_ms             = 0;
+
+// Ply being timed
+static uint64_t game_start_us       = 0;
+static uint64_t ply_start_us        = 0;
+static replay_result_t ply_start;               // Metric totals when the ply started
+
+/**
+ * @brief Starts the replay from the initial position (instead of a game), unless one is running
+ */
+void replay_start(void)
+{
+    if (replay_running)
+    {
+        return;
+    }
+
+    // Play the loaded game, if there is one
+    if (loaded_plies > 0)
+    {
+        p_game     = (const char (*)[REPLAY_MOVE_LENGTH]) loaded_moves;
+        game_plies = loaded_plies;
+    }
+    else
+    {
+        p_game     = replay_moves;
+        game_plies = NUMBER_OF_REPLAY_PLIES;
+    }
+
+    replay_running = true;
+    plies_done     = 0;
+    game_done      = false;
+
+    chessboard_reset_all();
+    metrics_new_game();
+
+    // Start from home, like a game
+    gantry_home();
+    command_queue_push((command_t*) replay_build_command(0));
+}
+
+/**
+ * @brief Appends the moves on a line to the loaded game, or clears it if there are none (a debug port reader)
+ *
+ * @param p_line The moves, separated by spaces
+ * @param length Length of the line
+ */
+void replay_load_moves(const char* p_line, uint8_t length)
+{
+    uint16_t plies = loaded_plies;
+    uint8_t i = 0;
+    bool empty = true;
+
+    p_load_error = 0;
+    if (replay_running)
+    {
+        p_load_error = "busy";
+        return;
+    }
+
+    while (i < length)
+    {
+        // Skip the separators
+        if (p_line[i] == ' ')
+        {
+            i++;
+            continue;
+        }
+        empty = false;
+
+        // Each move is a whole word
+        if (((length - i) < REPLAY_MOVE_LENGTH) ||
+            (((length - i) > REPLAY_MOVE_LENGTH) && (p_line[i + REPLAY_MOVE_LENGTH] != ' ')) ||
+            (!replay_is_valid_move(&p_line[i])))
+        {
+            p_load_error = "bad move";
+            return;
+        }
+        if (plies >= REPLAY_MAX_PLIES)
+        {
+            p_load_error = "full";
+            return;
+        }
+
+        // Staged past the end of the game until the whole line checks out
+        memcpy(loaded_moves[plies++], &p_line[i], REPLAY_MOVE_LENGTH);
+        i += REPLAY_MOVE_LENGTH;
+    }
+
+    loaded_plies = empty ? 0 : plies;
+}
+
+/**
+ * @brief Writes the answer to a line of moves (a debug port writer)
+ *
+ * @param index Line number
+ * @param p_buffer Storage for the line
+ * @param size Size of the buffer
+ * @return The line length (0 once the answer is done)
+ */
+uint8_t replay_write_load(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    int length = 0;
+
+    if (index > 0)
+    {
+        return 0;
+    }
+
+    if (p_load_error)
+    {
+        length = snprintf((char*) p_buffer, size, "error,%s\r\n", p_load_error);
+    }
+    else
+    {
+        length = snprintf((char*) p_buffer, size, "loaded,%u\r\n", loaded_plies);
+    }
+
+    if (length >= size)
+    {
+        length = size - 1;
+    }
+    return (length > 0) ? (uint8_t) length : 0;
+}
+
+/**
+ * @brief Writes one line of the CSV report (a debug port writer)
+ *
+ * @param index Line number
+ * @param p_buffer Storage for the line
+ * @param size Size of the buffer
+ * @return The line length (0 once the report is done)
+ */
+uint8_t replay_write_report(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    int length = 0;
+
+    if (index == 0)
+    {
+        length = snprintf((char*) p_buffer, size, "ply,move,total_ms,travel_ms,z_ms,dwell_ms,homing_ms\r\n");
+    }
+    else if (index <= plies_done)
+    {
+        const replay_result_t* p_result = &results[index - 1];
+        const char* p_move = p_game[index - 1];
+        length = snprintf((char*) p_buffer, size, "%u,%.5s,%lu,%lu,%lu,%lu,%lu\r\n", index, p_move,
+                          (unsigned long) p_result->total_ms, (unsigned long) p_result->travel_ms,
+                          (unsigned long) p_result->z_ms, (unsigned long) p_result->dwell_ms,
+                          (unsigned long) p_result->homing_ms);
+    }
+    else if ((index == (plies_done + 1)) && game_done)
+    {
+        length = snprintf((char*) p_buffer, size, "game,%u,%lu\r\n", plies_done, (unsigned long) game_ms);
+    }
+
+    if (length >= size)
+    {
+        length = size - 1;
+    }
+    return (length > 0) ? (uint8_t) length : 0;
+}
+
+/* Command Functions */
+
+/**
+ * @brief Builds a replay command
+ *
+ * @param ply The ply to start (the one before it is finished first)
+ * @return Pointer to the dynamically-allocated command
+ */
+replay_command_t* replay_build_command(uint16_t ply)
+{
+    // The thing to return
+    replay_command_t* p_command = (replay_command_t*) memstats_malloc(sizeof(replay_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
+
+    // Functions
+    p_command->command.p_entry   = &replay_entry;
+    p_command->command.p_action  = &utils_empty_function;
+    p_command->command.p_exit    = &utils_empty_function;
+    p_command->command.p_is_done = &replay_is_done;
+
+    // Data
+    p_command->ply = ply;
+
+    return p_command;
+}
+
+/**
+ * @brief Finishes timing the previous ply, then queues the next one followed by another replay command
+ *
+ * @param command The replay command being run
+ */
+void replay_entry(command_t* command)
+{
+    replay_command_t* p_replay_command = (replay_command_t*) command;
+    uint16_t ply = p_replay_command->ply;
+    uint64_t now_us = timebase_now_us();
+    replay_result_t totals;
+
+    // The previous ply is done
+    replay_snapshot(&totals);
+    if (ply > 0)
+    {
+        replay_result_t* p_result = &results[ply - 1];
+        p_result->total_ms  = (uint32_t) ((now_us - ply_start_us) / 1000);
+        p_result->travel_ms = totals.travel_ms - ply_start.travel_ms;
+        p_result->z_ms      = totals.z_ms - ply_start.z_ms;
+        p_result->dwell_ms  = totals.dwell_ms - ply_start.dwell_ms;
+        p_result->homing_ms = totals.homing_ms - ply_start.homing_ms;
+        plies_done = ply;
+    }
+    else
+    {
+        game_start_us = now_us;
+    }
+
+    // The game is done
+    if (ply >= game_plies)
+    {
+        game_ms        = (uint32_t) ((now_us - game_start_us) / 1000);
+        game_done      = true;
+        replay_running = false;
+        led_mode(LED_OFF);
+        return;
+    }
+
+    // Queue the ply, the same way as a move from the Pi
+    char move[REPLAY_MOVE_LENGTH];
+    chess_move_t chess_move;
+    uint8_t i = 0;
+    for (i = 0; i < REPLAY_MOVE_LENGTH; i++)
+    {
+        move[i] = p_game[ply][i];
+    }
+    chess_move.source_file = utils_byte_to_file(move[0]);
+    chess_move.source_rank = utils_byte_to_rank(move[1]);
+    chess_move.dest_file   = utils_byte_to_file(move[2]);
+    chess_move.dest_rank   = utils_byte_to_rank(move[3]);
+    chess_move.move_type   = utils_byte_to_move_type(move[4]);
+
+    ply_start    = totals;
+    ply_start_us = now_us;
+    led_mode(LED_ROBOT_MOVE);
+    gantry_robot_queue_move(&chess_move);
+    chessboard_update_previous_board_from_move(move);
+
+    command_queue_push((command_t*) replay_build_command(ply + 1));
+}
+
+/**
+ * @brief Always done (everything happens in the entry function)
+ *
+ * @param command The replay command being run
+ * @return true Always
+ */
+bool replay_is_done(command_t* command)
+{
+    return true;
+}
+
+/**
+ * @brief Helper function to check a move has the ROBOT_MOVE format (squares on the board, a known move type)
+ *
+ * @param p_move The move (REPLAY_MOVE_LENGTH bytes)
+ * @return true if the replay can play it
+ */
+static bool replay_is_valid_move(const char* p_move)
+{
+    return ((p_move[0] >= 'a') && (p_move[0] <= 'h') && (p_move[1] >= '1') && (p_move[1] <= '8') &&
+            (p_move[2] >= 'a') && (p_move[2] <= 'h') && (p_move[3] >= '1') && (p_move[3] <= '8') &&
+            (p_move[4] != '\0') && (strchr("_CcEQq", p_move[4]) != NULL));
+}
+
+/**
+ * @brief Helper function to read the metric totals a ply is split into
+ *
+ * @param p_totals Storage for the totals (total_ms is not used)
+ */
+static void replay_snapshot(replay_result_t* p_totals)
+{
+    p_totals->total_ms  = 0;
+    p_totals->travel_ms = metrics_get_summary(METRICS_TRAVEL).total_ms;
+    p_totals->z_ms      = metrics_get_summary(METRICS_Z).total_ms;
+    p_totals->dwell_ms  = metrics_get_summary(METRICS_DWELL).total_ms;
+    p_totals->homing_ms = metrics_get_summary(METRICS_HOMING).total_ms;
+}
+
+/* End replay.c */
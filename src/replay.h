@@ -0,0 +1,73 @@
+/**
+ * @file replay.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Replays a recorded game with the robot and times every move
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_
+
+// Note on the replay benchmark (enabled with REPLAY_MODE in utils.h):
+//  - The robot plays every ply of the game, for both sides, starting from the initial position. The game is
+//      the one loaded over the DEBUG_PORT, or replay_moves[] (replay.c) if none is. Moves use the Pi's
+//      ROBOT_MOVE format: source, destination, then the move type byte
+//      ('_' move, 'C' capture, 'c' castle, 'E' en passant, 'Q' promotion, 'q' capturing promotion)
+//  - The list stands in for the Pi, and no human turns are taken, so neither the Pi nor the sensor board is
+//      needed. Each ply is queued with gantry_robot_queue_move(), the same path as a real game
+//  - The DEBUG_PORT 'L' command appends moves to the loaded game, e.g., "L e2e4_ e7e5_ g1f3_" (separated by
+//      spaces, up to REPLAY_MAX_PLIES in all). A line with a bad move, or one that does not fit, is dropped
+//      whole, and 'L' alone clears the loaded game. 'L' answers "loaded,<plies>" or "error,<reason>"
+//  - Moves cannot be loaded while a replay runs. The game is picked when the replay starts: at boot, then
+//      with the 'g' command once the last replay is done (put the pieces back first)
+//  - A replay command between plies stamps the time. A ply's time covers everything it queued, including
+//      the homing after it. Travel, Z, dwell, and homing come from the game metrics (see metrics.h)
+//  - The DEBUG_PORT 'r' command reports the plies finished so far as CSV (times in ms):
+//      - "ply,move,total_ms,travel_ms,z_ms,dwell_ms,homing_ms", then one line per ply
+//      - Once the game is done, "game,<plies>,<total_ms>" (from the first ply's start to the last ply's end)
+//  - Compare runs by diffing the CSV (the list and the firmware are the only inputs)
+
+#include "msp.h"
+#include "chessboard.h"
+#include "command_queue.h"
+#include "metrics.h"
+#include "raspberrypi.h"
+#include "timebase.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General replay defines
+#define REPLAY_MOVE_LENGTH                  (5)
+#define REPLAY_MAX_PLIES                    (128)       // Longest game (loaded or compiled in)
+
+// Replay command
+typedef struct replay_command_t {
+    command_t command;
+    uint16_t ply;                                   // Next ply to start
+} replay_command_t;
+
+// Time spent on one ply
+typedef struct replay_result_t {
+    uint32_t total_ms;
+    uint32_t travel_ms;
+    uint32_t z_ms;
+    uint32_t dwell_ms;
+    uint32_t homing_ms;
+} replay_result_t;
+
+// Public functions
+void replay_start(void);
+void replay_load_moves(const char* p_line, uint8_t length);
+uint8_t replay_write_report(uint16_t index, uint8_t* p_buffer, uint8_t size);
+uint8_t replay_write_load(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+// Command Functions
+replay_command_t* replay_build_command(uint16_t ply);
+void replay_entry(command_t* command);
+bool replay_is_done(command_t* command);
+
+#endif /* REPLAY_H_ */
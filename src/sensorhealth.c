@@ -0,0 +1,252 @@
+/**
+ * @file sensorhealth.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Provides diagnostics for the reed switch sensor network (toggle counts, stuck-square detection)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "sensorhealth.h"
+
+// Private functions
+static uint8_t sensorhealth_count_bits(uint64_t value);
+
+// Declare the per-square state
+static sensorhealth_square_t squares[NUMBER_OF_SQUARES];
+
+// Private variables
+static uint64_t previous_reading = 0;
+static bool     has_previous     = false;
+static uint64_t previous_expected = 0;
+static bool     has_expected     = false;
+static uint64_t stuck_on_mask    = 0;
+static uint64_t stuck_off_mask   = 0;
+
+/**
+ * @brief Initialize the sensor health tracking (all squares start healthy)
+ */
+void sensorhealth_init(void)
+{
+    uint8_t i = 0;
+    for (i = 0; i < NUMBER_OF_SQUARES; i++)
+    {
+        squares[i].toggle_count   = 0;
+        squares[i].move_count     = 0;
+        squares[i].mismatch_count = 0;
+        squares[i].fault          = SQUARE_HEALTHY;
+    }
+
+    previous_reading  = 0;
+    has_previous      = false;
+    previous_expected = 0;
+    has_expected      = false;
+    stuck_on_mask    = 0;
+    stuck_off_mask   = 0;
+}
+
+/**
+ * @brief Helper function to count the set bits in a 64-bit value
+ *
+ * @param value The value to count
+ * @return The number of set bits
+ */
+static uint8_t sensorhealth_count_bits(uint64_t value)
+{
+    uint8_t count = 0;
+
+    // Clear the lowest set bit until none remain
+    while (value)
+    {
+        value &= (value - 1);
+        count++;
+    }
+
+    return count;
+}
+
+/**
+ * @brief Reads the sensor network and updates the toggle count of every square that changed
+ *
+ * @return The raw sensor reading
+ */
+uint64_t sensorhealth_get_reading(void)
+{
+    uint64_t reading = sensornetwork_get_reading();
+
+    // Both the main loop and the gantry handler take readings, so update the counts atomically
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // The first reading has nothing to compare against
+    if (!has_previous)
+    {
+        previous_reading = reading;
+        has_previous     = true;
+        __set_PRIMASK(primask);
+        return reading;
+    }
+
+    // Count the toggles on each changed square
+    uint64_t toggles = (reading ^ previous_reading);
+    uint8_t i = 0;
+    for (i = 0; (i < NUMBER_OF_SQUARES) && (toggles != 0); i++)
+    {
+        if ((toggles & BITS64_MASK(i)) && (squares[i].toggle_count < SENSORHEALTH_TOGGLE_COUNT_MAX))
+        {
+            squares[i].toggle_count++;
+        }
+        toggles &= ~BITS64_MASK(i);
+    }
+
+    previous_reading = reading;
+    __set_PRIMASK(primask);
+
+    return reading;
+}
+
+/**
+ * @brief Gathers one turn of evidence, flagging squares that never respond to legal moves.
+ *  Call this once per human turn, before the reading is decoded into a move
+ *
+ * @param reading The end-of-turn sensor reading (from sensorhealth_get_reading())
+ * @param expected_presence The presence stored by the chessboard module before the human's move
+ */
+void sensorhealth_check_turn(uint64_t reading, uint64_t expected_presence)
+{
+    uint8_t i = 0;
+
+    // Count the squares that legal moves (human or robot) have changed since the last turn
+    uint64_t moved = has_expected ? (expected_presence ^ previous_expected) : 0;
+    previous_expected = expected_presence;
+    has_expected      = true;
+    for (i = 0; (i < NUMBER_OF_SQUARES) && (moved != 0); i++)
+    {
+        if ((moved & BITS64_MASK(i)) && (squares[i].move_count < SENSORHEALTH_TOGGLE_COUNT_MAX))
+        {
+            squares[i].move_count++;
+        }
+        moved &= ~BITS64_MASK(i);
+    }
+
+    // Squares already flagged are accounted for; too many new mismatches means the board is being set up
+    uint64_t mismatches     = (reading ^ expected_presence);
+    uint64_t new_mismatches = mismatches & ~(stuck_on_mask | stuck_off_mask);
+    uint8_t total_degraded  = sensorhealth_count_bits(stuck_on_mask | stuck_off_mask);
+    if ((total_degraded + sensorhealth_count_bits(new_mismatches)) > SENSORHEALTH_MAX_DEGRADED)
+    {
+        new_mismatches = 0;
+    }
+
+    for (i = 0; i < NUMBER_OF_SQUARES; i++)
+    {
+        sensorhealth_square_t* p_square = &squares[i];
+        uint64_t square_mask = BITS64_MASK(i);
+
+        // Already flagged, nothing more to learn
+        if (p_square->fault != SQUARE_HEALTHY)
+        {
+            continue;
+        }
+
+        // A matching square, one that has ever toggled, or one no piece has legally moved on or off is not a suspect
+        if (!(new_mismatches & square_mask) || (p_square->toggle_count != 0) || (p_square->move_count == 0))
+        {
+            p_square->mismatch_count = 0;
+            continue;
+        }
+
+        // Flag the square once it has disagreed for enough turns
+        p_square->mismatch_count++;
+        if (p_square->mismatch_count >= SENSORHEALTH_STUCK_TURNS)
+        {
+            if (reading & square_mask)
+            {
+                p_square->fault = SQUARE_STUCK_ON;
+                stuck_on_mask  |= square_mask;
+            }
+            else
+            {
+                p_square->fault = SQUARE_STUCK_OFF;
+                stuck_off_mask |= square_mask;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Replaces the reading of each degraded square with its expected presence
+ *
+ * @param reading A sensor reading
+ * @param expected_presence The presence stored by the chessboard module
+ * @return The masked reading
+ */
+uint64_t sensorhealth_mask_reading(uint64_t reading, uint64_t expected_presence)
+{
+    uint64_t degraded = (stuck_on_mask | stuck_off_mask);
+
+    return ((reading & ~degraded) | (expected_presence & degraded));
+}
+
+/**
+ * @brief Gets the health bitmap of the board
+ *
+ * @return A 64-bit map with bit i set if square i is healthy
+ */
+uint64_t sensorhealth_get_health_bitmap(void)
+{
+    return ~(stuck_on_mask | stuck_off_mask);
+}
+
+/**
+ * @brief Gets the squares flagged as stuck-on (always reading a piece)
+ *
+ * @return A 64-bit map with bit i set if square i is stuck-on
+ */
+uint64_t sensorhealth_get_stuck_on(void)
+{
+    return stuck_on_mask;
+}
+
+/**
+ * @brief Gets the squares flagged as stuck-off (never reading a piece)
+ *
+ * @return A 64-bit map with bit i set if square i is stuck-off
+ */
+uint64_t sensorhealth_get_stuck_off(void)
+{
+    return stuck_off_mask;
+}
+
+/**
+ * @brief Gets the number of times a square has toggled
+ *
+ * @param index One of {0,...,63} for the square
+ * @return The toggle count (saturates at SENSORHEALTH_TOGGLE_COUNT_MAX)
+ */
+uint16_t sensorhealth_get_toggle_count(uint8_t index)
+{
+    if (index >= NUMBER_OF_SQUARES)
+    {
+        return 0;
+    }
+    return squares[index].toggle_count;
+}
+
+/**
+ * @brief Gets the fault state of a square
+ *
+ * @param index One of {0,...,63} for the square
+ * @return The fault state of the square
+ */
+sensorhealth_fault_t sensorhealth_get_fault(uint8_t index)
+{
+    if (index >= NUMBER_OF_SQUARES)
+    {
+        return SQUARE_HEALTHY;
+    }
+    return squares[index].fault;
+}
+
+/* End sensorhealth.c */
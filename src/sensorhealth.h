@@ -0,0 +1,66 @@
+/**
+ * @file sensorhealth.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Provides diagnostics for the reed switch sensor network (toggle counts, stuck-square detection)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef SENSORHEALTH_H_
+#define SENSORHEALTH_H_
+
+// Note on sensor health:
+//  - Every reading taken through sensorhealth_get_reading() updates a per-square toggle count
+//  - Evidence is only gathered at the end of each human turn (sensorhealth_check_turn()), never while
+//      validating the start state, so a piece that is simply missing or misplaced is not flagged
+//  - A square is only a suspect once pieces have legally moved on or off it (its expected presence has
+//      changed since the first check). A suspect that has never toggled and disagrees with the expected
+//      presence for SENSORHEALTH_STUCK_TURNS consecutive turns is flagged as stuck-on or stuck-off
+//  - A square that has toggled is never flagged, since a working sensor must have seen both states
+//  - If more than SENSORHEALTH_MAX_DEGRADED squares disagree at once, the board is assumed to be
+//      mid-setup and nothing is flagged
+//  - Degraded squares are masked out by replacing their reading with the expected presence. The
+//      board cannot see a human move onto or off of a masked square, so masking is a last resort
+//  - sensorhealth_get_reading() is called from both the main loop and the gantry handler, so the
+//      toggle bookkeeping runs with interrupts disabled
+
+#include "sensornetwork.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General sensor health defines
+#define NUMBER_OF_SQUARES                   (NUMBER_OF_ROWS * NUMBER_OF_COLS)
+#define SENSORHEALTH_STUCK_TURNS            (3)         // Consecutive mismatched turns before a square is flagged
+#define SENSORHEALTH_MAX_DEGRADED           (4)         // Most squares that may be flagged at once
+#define SENSORHEALTH_TOGGLE_COUNT_MAX       (0xFFFF)    // Toggle counts saturate here
+
+// Fault type for a single square
+typedef enum sensorhealth_fault_t {
+    SQUARE_HEALTHY,
+    SQUARE_STUCK_ON,
+    SQUARE_STUCK_OFF,
+} sensorhealth_fault_t;
+
+// Per-square diagnostic state
+typedef struct {
+    uint16_t toggle_count;              // Number of times the square changed state between readings
+    uint16_t move_count;                // Number of legal moves onto or off of the square (saturates)
+    uint16_t mismatch_count;            // Consecutive turns where the square disagreed with the expected presence
+    sensorhealth_fault_t fault;         // Whether the square has been flagged
+} sensorhealth_square_t;
+
+// Public functions
+void sensorhealth_init(void);
+uint64_t sensorhealth_get_reading(void);
+void sensorhealth_check_turn(uint64_t reading, uint64_t expected_presence);
+uint64_t sensorhealth_mask_reading(uint64_t reading, uint64_t expected_presence);
+uint64_t sensorhealth_get_health_bitmap(void);
+uint64_t sensorhealth_get_stuck_on(void);
+uint64_t sensorhealth_get_stuck_off(void);
+uint16_t sensorhealth_get_toggle_count(uint8_t index);
+sensorhealth_fault_t sensorhealth_get_fault(uint8_t index);
+
+#endif /* SENSORHEALTH_H_ */
@@ -9,10 +9,48 @@
  */
 
 #include "sensornetwork.h"
+#include "sensorscan.h"
 
 // Private functions
-static void sensornetwork_select_file(chess_file_t file);
-static uint8_t sensornetwork_read_rank(chess_rank_t rank);
+static void sensornetwork_select_file(uint8_t file_index);
+static uint8_t sensornetwork_read_rank(uint8_t rank_index);
+static uint8_t sensornetwork_file_bits(uint64_t board, uint8_t file_index);
+static uint8_t sensornetwork_read_file(void);
+static void sensornetwork_precharge_ranks(uint8_t levels);
+
+// Select code for each file (bit k drives select line k)
+static const uint8_t file_select_codes[NUMBER_OF_COLS] = {
+    0x1,    // A: Select == 001
+    0x0,    // B: Select == 000
+    0x2,    // C: Select == 010
+    0x3,    // D: Select == 011
+    0x4,    // E: Select == 100
+    0x5,    // F: Select == 101
+    0x7,    // G: Select == 111
+    0x6,    // H: Select == 110
+};
+
+// Select lines, indexed by select bit
+static GPIO_Type* const select_ports[NUMBER_OF_SENSOR_COL_SELECTS] = {
+    SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_2_PORT,
+};
+static const uint8_t select_pins[NUMBER_OF_SENSOR_COL_SELECTS] = {
+    SENSOR_COL_SELECT_0_PIN, SENSOR_COL_SELECT_1_PIN, SENSOR_COL_SELECT_2_PIN,
+};
+
+// Rank data lines, indexed by rank
+static GPIO_Type* const rank_ports[NUMBER_OF_ROWS] = {
+    SENSOR_ROW_DATA_1_PORT, SENSOR_ROW_DATA_2_PORT, SENSOR_ROW_DATA_3_PORT, SENSOR_ROW_DATA_4_PORT,
+    SENSOR_ROW_DATA_5_PORT, SENSOR_ROW_DATA_6_PORT, SENSOR_ROW_DATA_7_PORT, SENSOR_ROW_DATA_8_PORT,
+};
+static const uint8_t rank_pins[NUMBER_OF_ROWS] = {
+    SENSOR_ROW_DATA_1_PIN, SENSOR_ROW_DATA_2_PIN, SENSOR_ROW_DATA_3_PIN, SENSOR_ROW_DATA_4_PIN,
+    SENSOR_ROW_DATA_5_PIN, SENSOR_ROW_DATA_6_PIN, SENSOR_ROW_DATA_7_PIN, SENSOR_ROW_DATA_8_PIN,
+};
+
+// Private variables
+static uint32_t settle_cycles[NUMBER_OF_COLS];
+static bool     is_calibrated = false;
 
 /**
  * @brief Initialize the sensor select and data lines
@@ -27,6 +65,14 @@ void sensornetwork_init(void)
     gpio_set_output_low(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
     gpio_set_output_low(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
 
+    // Start from the known-safe settle time until calibrated
+    int i = 0;
+    for (i = 0; i < NUMBER_OF_COLS; i++)
+    {
+        settle_cycles[i] = SENSORNETWORK_SETTLE_DEFAULT_CYCLES;
+    }
+    is_calibrated = false;
+
     // Configure sensor row lines
     gpio_set_as_input(SENSOR_ROW_DATA_1_PORT, SENSOR_ROW_DATA_1_PIN);
     gpio_set_as_input(SENSOR_ROW_DATA_2_PORT, SENSOR_ROW_DATA_2_PIN);
@@ -36,123 +82,129 @@ void sensornetwork_init(void)
     gpio_set_as_input(SENSOR_ROW_DATA_6_PORT, SENSOR_ROW_DATA_6_PIN);
     gpio_set_as_input(SENSOR_ROW_DATA_7_PORT, SENSOR_ROW_DATA_7_PIN);
     gpio_set_as_input(SENSOR_ROW_DATA_8_PORT, SENSOR_ROW_DATA_8_PIN);
+
+#ifdef SENSOR_DMA_SCAN
+    sensorscan_init();
+    sensorscan_start();
+#endif
 }
 
 /**
- * @brief Selects a given tile to read
+ * @brief Selects a given file to read
  * 
- * @param file The column to select
+ * @param file_index One of {0,...,7} for the file to select
  */
-static void sensornetwork_select_file(chess_file_t file)
+static void sensornetwork_select_file(uint8_t file_index)
 {
-    // Set the row select lines
-    switch (file)
+    // Invalid file, do nothing
+    if (file_index >= NUMBER_OF_COLS)
     {
-        case A: // Select == 001
-            gpio_set_output_low(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case B: // Select == 000
-            gpio_set_output_low(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case C: // Select == 010
-            gpio_set_output_low(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case D: // Select == 011
-            gpio_set_output_low(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case E: // Select == 100
-            gpio_set_output_high(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case F: // Select == 101
-            gpio_set_output_high(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case G: // Select == 111
-            gpio_set_output_high(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        case H: // Select == 110
-            gpio_set_output_high(SENSOR_COL_SELECT_2_PORT, SENSOR_COL_SELECT_2_PIN);
-            gpio_set_output_high(SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_1_PIN);
-            gpio_set_output_low(SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_0_PIN);
-        break;
-
-        default:
-            // Invalid file, do nothing
-        break;
+        return;
+    }
+
+    // Set the select lines from the file's select code
+    uint8_t code = file_select_codes[file_index];
+    int k = 0;
+    for (k = 0; k < NUMBER_OF_SENSOR_COL_SELECTS; k++)
+    {
+        if (code & (1 << k))
+        {
+            gpio_set_output_high(select_ports[k], select_pins[k]);
+        }
+        else
+        {
+            gpio_set_output_low(select_ports[k], select_pins[k]);
+        }
     }
 }
 
 /**
  * @brief Reads a given row
  *
- * @param rank The row to select
+ * @param rank_index One of {0,...,7} for the row to read
  * @return The reading of the given tile
  */
-static uint8_t sensornetwork_read_rank(chess_rank_t rank)
+static uint8_t sensornetwork_read_rank(uint8_t rank_index)
 {
-    uint8_t reading = 0;
-
-    // Set the column select lines
-    switch (rank)
+    // Invalid rank, do nothing
+    if (rank_index >= NUMBER_OF_ROWS)
     {
-        case FIRST:     // Select == 000
-            reading = gpio_read_input(SENSOR_ROW_DATA_1_PORT, SENSOR_ROW_DATA_1_PIN);
-        break;
+        return 0;
+    }
 
-        case SECOND:    // Select == 001
-            reading = gpio_read_input(SENSOR_ROW_DATA_2_PORT, SENSOR_ROW_DATA_2_PIN);
-        break;
+    return gpio_read_input(rank_ports[rank_index], rank_pins[rank_index]);
+}
 
-        case THIRD:     // Select == 010
-            reading = gpio_read_input(SENSOR_ROW_DATA_3_PORT, SENSOR_ROW_DATA_3_PIN);
-        break;
+/**
+ * @brief Gathers the 8 squares of one file out of a board bitmap
+ *
+ * @param board A 64-bit board map (tile index = file + 8*rank)
+ * @param file_index One of {0,...,7} for the file
+ * @return The squares of the file, with bit j set for rank j
+ */
+static uint8_t sensornetwork_file_bits(uint64_t board, uint8_t file_index)
+{
+    uint8_t file_bits = 0;
 
-        case FOURTH:    // Select == 011
-            reading = gpio_read_input(SENSOR_ROW_DATA_4_PORT, SENSOR_ROW_DATA_4_PIN);
-        break;
+    int j = 0;
+    for (j = 0; j < NUMBER_OF_ROWS; j++)
+    {
+        if (board & BITS64_MASK((file_index + NUMBER_OF_COLS*j)))
+        {
+            file_bits |= (1 << j);
+        }
+    }
+
+    return file_bits;
+}
 
-        case FIFTH:     // Select == 100
-            reading = gpio_read_input(SENSOR_ROW_DATA_5_PORT, SENSOR_ROW_DATA_5_PIN);
-        break;
+/**
+ * @brief Reads all ranks of the currently selected file
+ *
+ * @return The readings, with bit j set if rank j read a piece
+ */
+static uint8_t sensornetwork_read_file(void)
+{
+    uint8_t file_reading = 0;
 
-        case SIXTH:     // Select == 101
-            reading = gpio_read_input(SENSOR_ROW_DATA_6_PORT, SENSOR_ROW_DATA_6_PIN);
-        break;
+    int j = 0;
+    for (j = 0; j < NUMBER_OF_ROWS; j++)
+    {
+        file_reading |= (sensornetwork_read_rank(j) << j);
+    }
 
-        case SEVENTH:   // Select == 110
-            reading = gpio_read_input(SENSOR_ROW_DATA_7_PORT, SENSOR_ROW_DATA_7_PIN);
-        break;
+    return file_reading;
+}
 
-        case EIGHTH:    // Select == 111
-            reading = gpio_read_input(SENSOR_ROW_DATA_8_PORT, SENSOR_ROW_DATA_8_PIN);
-        break;
+/**
+ * @brief Drives each rank line to the given level, then releases it back to an input
+ *
+ * @param levels Bit j set drives rank j high, clear drives it low
+ */
+static void sensornetwork_precharge_ranks(uint8_t levels)
+{
+    int j = 0;
 
-        default:
-            // Invalid rank, do nothing
-        break;
+    // Drive the lines (set the direction first, since gpio_set_as_output() also clears the output)
+    for (j = 0; j < NUMBER_OF_ROWS; j++)
+    {
+        gpio_set_as_output(rank_ports[j], rank_pins[j]);
+        if (levels & (1 << j))
+        {
+            gpio_set_output_high(rank_ports[j], rank_pins[j]);
+        }
+        else
+        {
+            gpio_set_output_low(rank_ports[j], rank_pins[j]);
+        }
     }
+    utils_delay_cycles(SENSORNETWORK_PRECHARGE_CYCLES);
 
-    return reading;
+    // Release the lines
+    for (j = 0; j < NUMBER_OF_ROWS; j++)
+    {
+        gpio_set_as_input(rank_ports[j], rank_pins[j]);
+    }
 }
 
 /**
@@ -163,30 +215,200 @@ static uint8_t sensornetwork_read_rank(chess_rank_t rank)
 uint64_t sensornetwork_get_reading(void)
 {
     uint64_t sensor_reading = 0;
-    chess_file_t file = A;
-    chess_rank_t rank = FIRST;
+    uint8_t file_reading = 0;
+
+#ifdef SENSOR_DMA_SCAN
+    // Use the latest frame from the scan engine, scanning directly only until the first one completes
+    if (sensorscan_get_reading(&sensor_reading))
+    {
+        return sensor_reading;
+    }
+
+    // The CPU needs the select lines to itself (the partial frame is restarted afterwards)
+    sensorscan_stop();
+#endif
 
-    // Loop through all tiles
+    // Loop through all files
     int i = 0;
     int j = 0;
     for (i = 0; i < NUMBER_OF_COLS; i++)
     {
         // Select the file
-        file = utils_index_to_file(i);
-        sensornetwork_select_file(file);
+        sensornetwork_select_file(i);
 
+        // Delay due to propogation, then read every rank at once
+        utils_delay_cycles(settle_cycles[i]);
+        file_reading = sensornetwork_read_file();
+
+        // Place each rank at its tile index
         for (j = 0; j < NUMBER_OF_ROWS; j++)
         {
-            // Delay due to propogation
-            utils_delay(300);
-
-            // Read the rank
-            rank = utils_index_to_rank(j);
-            sensor_reading |= (((uint64_t) sensornetwork_read_rank(rank)) << utils_tile_to_index(file, rank));
+            if (file_reading & (1 << j))
+            {
+                sensor_reading |= BITS64_MASK((i + NUMBER_OF_COLS*j));
+            }
         }
     }
 
+#ifdef SENSOR_DMA_SCAN
+    sensorscan_start();
+#endif
+
     return sensor_reading;
 }
 
+/**
+ * @brief Finds the shortest settle time for each file while the board is in a known position.
+ *  Files that cannot be calibrated keep their previous settle time
+ *
+ * @param expected_presence The presence the board is known to have (e.g., INITIAL_PRESENCE_BOARD)
+ * @param valid_mask Squares that can be trusted (e.g., from sensorhealth_get_health_bitmap())
+ * @return true if every file was calibrated
+ */
+bool sensornetwork_calibrate(uint64_t expected_presence, uint64_t valid_mask)
+{
+    bool all_calibrated = true;
+
+#ifdef SENSOR_DMA_SCAN
+    // The CPU needs the select lines to itself
+    sensorscan_stop();
+#endif
+
+    int i = 0;
+    for (i = 0; i < NUMBER_OF_COLS; i++)
+    {
+        uint8_t expected = sensornetwork_file_bits(expected_presence, i);
+        uint8_t valid    = sensornetwork_file_bits(valid_mask, i);
+        bool file_done   = false;
+
+        // Make sure the file settles at all before sweeping
+        sensornetwork_select_file(i);
+        utils_delay_cycles(SENSORNETWORK_SETTLE_DEFAULT_CYCLES);
+        if ((sensornetwork_read_file() & valid) != (expected & valid))
+        {
+            all_calibrated = false;
+            continue;
+        }
+
+        // Sweep from short to long settle times
+        uint32_t cycles = 0;
+        for (cycles = SENSORNETWORK_SETTLE_STEP_CYCLES; (cycles <= SENSORNETWORK_SETTLE_DEFAULT_CYCLES) && !file_done; cycles += SENSORNETWORK_SETTLE_STEP_CYCLES)
+        {
+            file_done = true;
+
+            int trial = 0;
+            for (trial = 0; (trial < SENSORNETWORK_CALIBRATION_TRIALS) && file_done; trial++)
+            {
+                // Start every rank line at the wrong level, then time how long it takes to recover
+                sensornetwork_select_file(i);
+                sensornetwork_precharge_ranks(~expected);
+                utils_delay_cycles(cycles);
+
+                if ((sensornetwork_read_file() & valid) != (expected & valid))
+                {
+                    file_done = false;
+                }
+            }
+
+            // Store the settle time with a margin
+            if (file_done)
+            {
+                uint32_t calibrated = (cycles * SENSORNETWORK_SETTLE_MARGIN);
+                if (calibrated < SENSORNETWORK_SETTLE_MIN_CYCLES)
+                {
+                    calibrated = SENSORNETWORK_SETTLE_MIN_CYCLES;
+                }
+                if (calibrated > SENSORNETWORK_SETTLE_DEFAULT_CYCLES)
+                {
+                    calibrated = SENSORNETWORK_SETTLE_DEFAULT_CYCLES;
+                }
+                settle_cycles[i] = calibrated;
+            }
+        }
+
+        if (!file_done)
+        {
+            all_calibrated = false;
+        }
+    }
+
+    is_calibrated = all_calibrated;
+
+#ifdef SENSOR_DMA_SCAN
+    sensorscan_start();
+#endif
+
+    return all_calibrated;
+}
+
+/**
+ * @brief Checks if every file has a calibrated settle time
+ *
+ * @return true if the last calibration succeeded
+ */
+bool sensornetwork_is_calibrated(void)
+{
+    return is_calibrated;
+}
+
+/**
+ * @brief Gets the settle time used for a file
+ *
+ * @param file_index One of {0,...,7} for the file
+ * @return The settle time in core clock cycles
+ */
+uint32_t sensornetwork_get_settle_cycles(uint8_t file_index)
+{
+    if (file_index >= NUMBER_OF_COLS)
+    {
+        return 0;
+    }
+    return settle_cycles[file_index];
+}
+
+/**
+ * @brief Gets the select code of a file (bit k drives select line k)
+ *
+ * @param file_index One of {0,...,7} for the file
+ * @return The select code
+ */
+uint8_t sensornetwork_get_select_code(uint8_t file_index)
+{
+    if (file_index >= NUMBER_OF_COLS)
+    {
+        return 0;
+    }
+    return file_select_codes[file_index];
+}
+
+/**
+ * @brief Gets the port of a rank data line
+ *
+ * @param rank_index One of {0,...,7} for the rank
+ * @return The port, or NULL for an invalid rank
+ */
+GPIO_Type* sensornetwork_get_rank_port(uint8_t rank_index)
+{
+    if (rank_index >= NUMBER_OF_ROWS)
+    {
+        return NULL;
+    }
+    return rank_ports[rank_index];
+}
+
+/**
+ * @brief Gets the pin of a rank data line
+ *
+ * @param rank_index One of {0,...,7} for the rank
+ * @return The pin, or 0 for an invalid rank
+ */
+uint8_t sensornetwork_get_rank_pin(uint8_t rank_index)
+{
+    if (rank_index >= NUMBER_OF_ROWS)
+    {
+        return 0;
+    }
+    return rank_pins[rank_index];
+}
+
 /* End sensornetwork.c */
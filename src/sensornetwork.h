@@ -15,12 +15,18 @@
 //  - Assumes a multiplexed crosspoint array
 //  - Sends signals on the rows, reads on the columns
 //  - Due to propogation delay in the diodes, reading is on-demand (no interrupt)
+//  - After selecting a file, the rank lines are given a settle time before all 8 are read. The settle
+//      time starts at SENSORNETWORK_SETTLE_DEFAULT_CYCLES and is calibrated per file with
+//      sensornetwork_calibrate() while the board is in a known position (e.g., the starting position)
+//  - Calibration drives each rank line to the opposite of its expected value, releases it, and finds the
+//      shortest settle time that reads the expected value every trial. The stored time adds a margin on top
 
 #include "msp.h"
 #include "clock.h"
 #include "gpio.h"
 #include "utils.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 // General sensor defines
 #define NUMBER_OF_ROWS                      (8)
@@ -28,6 +34,14 @@
 #define NUMBER_OF_SENSOR_ROW_SELECTS        (3)
 #define NUMBER_OF_SENSOR_COL_SELECTS        (3)
 
+// Settle time defines (in core clock cycles)
+#define SENSORNETWORK_SETTLE_DEFAULT_CYCLES (CLOCK_US_TO_CYCLES(30))        // Known to be safe on the board
+#define SENSORNETWORK_SETTLE_MIN_CYCLES     (CLOCK_US_TO_CYCLES(1))         // Never settle for less than this
+#define SENSORNETWORK_SETTLE_STEP_CYCLES    (CLOCK_NS_TO_CYCLES(500))       // Resolution of the calibration sweep
+#define SENSORNETWORK_SETTLE_MARGIN         (2)                             // Calibrated time is multiplied by this
+#define SENSORNETWORK_CALIBRATION_TRIALS    (16)                            // Consecutive good reads needed at a settle time
+#define SENSORNETWORK_PRECHARGE_CYCLES      (CLOCK_US_TO_CYCLES(2))         // Time the rank lines are driven before a trial
+
 // Sensor cols
 #define SENSOR_COL_SELECT_0_PORT            (GPIOD)
 #define SENSOR_COL_SELECT_0_PIN             (GPIO_PIN_1)
@@ -57,5 +71,11 @@
 // Public functions
 void sensornetwork_init(void);
 uint64_t sensornetwork_get_reading(void);
+bool sensornetwork_calibrate(uint64_t expected_presence, uint64_t valid_mask);
+bool sensornetwork_is_calibrated(void);
+uint32_t sensornetwork_get_settle_cycles(uint8_t file_index);
+uint8_t sensornetwork_get_select_code(uint8_t file_index);
+GPIO_Type* sensornetwork_get_rank_port(uint8_t rank_index);
+uint8_t sensornetwork_get_rank_pin(uint8_t rank_index);
 
 #endif /* SENSORNETWORK_H_ */
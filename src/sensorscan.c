@@ -0,0 +1,297 @@
+/**
+ * @file sensorscan.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Optional uDMA scan engine for the reed switch sensor network
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "sensorscan.h"
+
+// Private functions
+static volatile uint8_t* sensorscan_masked_data(GPIO_Type* port, uint8_t mask);
+static void sensorscan_build_task_list(uint8_t buffer);
+static void sensorscan_arm(uint8_t buffer);
+
+// Select lines, indexed by select bit
+static GPIO_Type* const select_ports[NUMBER_OF_SENSOR_COL_SELECTS] = {
+    SENSOR_COL_SELECT_0_PORT, SENSOR_COL_SELECT_1_PORT, SENSOR_COL_SELECT_2_PORT,
+};
+static const uint8_t select_pins[NUMBER_OF_SENSOR_COL_SELECTS] = {
+    SENSOR_COL_SELECT_0_PIN, SENSOR_COL_SELECT_1_PIN, SENSOR_COL_SELECT_2_PIN,
+};
+
+// Declare the ping-pong buffers and their task lists
+static sensorscan_frame_t frames[2];
+static udma_control_t task_lists[2][SENSORSCAN_TASKS_PER_FRAME];
+
+// Values written to each select port to select a file, indexed by [file][select port]
+static uint8_t select_values[NUMBER_OF_COLS][SENSORSCAN_PORTS_PER_FILE];
+
+// Decode tables, indexed by rank
+static uint8_t rank_slots[NUMBER_OF_ROWS];
+static uint8_t rank_pins[NUMBER_OF_ROWS];
+
+// Private variables
+static volatile uint8_t* row_data[SENSORSCAN_PORTS_PER_FILE];
+static volatile uint8_t* select_data[SENSORSCAN_PORTS_PER_FILE];
+static volatile bool     scan_running  = false;
+static volatile bool     frame_ready   = false;
+static volatile uint8_t  active_buffer = 0;
+static volatile uint8_t  ready_buffer  = 0;
+static volatile uint32_t frame_count   = 0;
+
+/**
+ * @brief Initialize the scan engine (call after sensornetwork_init())
+ */
+void sensorscan_init(void)
+{
+    GPIO_Type* row_ports[SENSORSCAN_PORTS_PER_FILE]    = {SENSORSCAN_ROW_PORT_0, SENSORSCAN_ROW_PORT_1};
+    GPIO_Type* select_port[SENSORSCAN_PORTS_PER_FILE]  = {SENSORSCAN_SELECT_PORT_0, SENSORSCAN_SELECT_PORT_1};
+    uint8_t row_masks[SENSORSCAN_PORTS_PER_FILE]       = {0, 0};
+    uint8_t select_masks[SENSORSCAN_PORTS_PER_FILE]    = {0, 0};
+    int i = 0;
+    int j = 0;
+    int k = 0;
+
+    // Sort the rank lines onto the two row ports
+    for (j = 0; j < NUMBER_OF_ROWS; j++)
+    {
+        rank_slots[j] = (sensornetwork_get_rank_port(j) == SENSORSCAN_ROW_PORT_0) ? 0 : 1;
+        rank_pins[j]  = sensornetwork_get_rank_pin(j);
+        row_masks[rank_slots[j]] |= rank_pins[j];
+    }
+
+    // Build the select port values for every file
+    for (i = 0; i < NUMBER_OF_COLS; i++)
+    {
+        uint8_t code = sensornetwork_get_select_code(i);
+        select_values[i][0] = 0;
+        select_values[i][1] = 0;
+
+        for (k = 0; k < NUMBER_OF_SENSOR_COL_SELECTS; k++)
+        {
+            uint8_t slot = (select_ports[k] == SENSORSCAN_SELECT_PORT_0) ? 0 : 1;
+            select_masks[slot] |= select_pins[k];
+            if (code & (1 << k))
+            {
+                select_values[i][slot] |= select_pins[k];
+            }
+        }
+    }
+
+    // Only the sensor pins of each port are touched through the masked DATA addresses
+    for (k = 0; k < SENSORSCAN_PORTS_PER_FILE; k++)
+    {
+        row_data[k]    = sensorscan_masked_data(row_ports[k], row_masks[k]);
+        select_data[k] = sensorscan_masked_data(select_port[k], select_masks[k]);
+    }
+
+    // Configure the uDMA channel and both task lists
+    udma_init();
+    udma_assign_channel(SENSORSCAN_UDMA_CHANNEL, SENSORSCAN_UDMA_ENCODING);
+    sensorscan_build_task_list(0);
+    sensorscan_build_task_list(1);
+
+    scan_running  = false;
+    frame_ready   = false;
+    active_buffer = 0;
+    ready_buffer  = 0;
+    frame_count   = 0;
+}
+
+/**
+ * @brief Gets the address of a port's DATA register that only accesses the masked pins
+ *
+ * @param port The GPIO port
+ * @param mask The pins to access
+ * @return The masked DATA address
+ */
+static volatile uint8_t* sensorscan_masked_data(GPIO_Type* port, uint8_t mask)
+{
+    // GPIO address bits [9:2] mask the DATA register
+    return (volatile uint8_t*) (((uint32_t) port) + (((uint32_t) mask) << 2));
+}
+
+/**
+ * @brief Builds the scatter-gather task list that fills one ping-pong buffer
+ *
+ * @param buffer One of {0, 1}
+ */
+static void sensorscan_build_task_list(uint8_t buffer)
+{
+    // Every task moves a single byte between fixed addresses, and waits for its own timer request
+    uint32_t task_control = (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_NONE |
+                             UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_ARBSIZE_1 | (0 << UDMA_CHCTL_XFERSIZE_S));
+    udma_control_t* p_task = task_lists[buffer];
+
+    int i = 0;
+    for (i = 0; i < NUMBER_OF_COLS; i++)
+    {
+        uint8_t next_file = (i + 1) % NUMBER_OF_COLS;
+
+        // Sample the selected file
+        p_task[0].p_src_end = row_data[0];
+        p_task[0].p_dst_end = &frames[buffer][i][0];
+        p_task[1].p_src_end = row_data[1];
+        p_task[1].p_dst_end = &frames[buffer][i][1];
+
+        // Select the next file (the last file selects A, ready for the next frame)
+        p_task[2].p_src_end = &select_values[next_file][0];
+        p_task[2].p_dst_end = select_data[0];
+        p_task[3].p_src_end = &select_values[next_file][1];
+        p_task[3].p_dst_end = select_data[1];
+
+        int k = 0;
+        for (k = 0; k < SENSORSCAN_TASKS_PER_FILE; k++)
+        {
+            p_task[k].control = (task_control | UDMA_CHCTL_XFERMODE_PER_SGA);
+            p_task[k].spare   = 0;
+        }
+        p_task += SENSORSCAN_TASKS_PER_FILE;
+    }
+
+    // The last task stops the channel once the frame is done
+    task_lists[buffer][SENSORSCAN_TASKS_PER_FRAME - 1].control = (task_control | UDMA_CHCTL_XFERMODE_BASIC);
+}
+
+/**
+ * @brief Points the channel at a buffer's task list and enables it
+ *
+ * @param buffer One of {0, 1}
+ */
+static void sensorscan_arm(uint8_t buffer)
+{
+    udma_control_t* p_primary = udma_get_primary(SENSORSCAN_UDMA_CHANNEL);
+
+    // The primary structure copies each task (4 words) into the alternate structure
+    p_primary->p_src_end = &task_lists[buffer][SENSORSCAN_TASKS_PER_FRAME - 1].spare;
+    p_primary->p_dst_end = &udma_get_alternate(SENSORSCAN_UDMA_CHANNEL)->spare;
+    p_primary->control   = (UDMA_CHCTL_DSTINC_32 | UDMA_CHCTL_DSTSIZE_32 | UDMA_CHCTL_SRCINC_32 |
+                            UDMA_CHCTL_SRCSIZE_32 | UDMA_CHCTL_ARBSIZE_4 |
+                            (((4 * SENSORSCAN_TASKS_PER_FRAME) - 1) << UDMA_CHCTL_XFERSIZE_S) |
+                            UDMA_CHCTL_XFERMODE_PER_SG);
+
+    active_buffer = buffer;
+    udma_enable_channel(SENSORSCAN_UDMA_CHANNEL);
+}
+
+/**
+ * @brief Starts scanning from file A. The timer must already be running
+ */
+void sensorscan_start(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    // Select file A so the first sample is valid
+    *select_data[0] = select_values[0][0];
+    *select_data[1] = select_values[0][1];
+
+    // Arm the channel and let the timer's timeouts request transfers
+    scan_running = true;
+    sensorscan_arm(active_buffer);
+    SENSORSCAN_TIMER->DMAEV |= TIMER_DMAEV_TATODMAEN;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Stops scanning (e.g., so the CPU can drive the select lines). The last ready frame stays available
+ */
+void sensorscan_stop(void)
+{
+    // sensorscan_service() must not see the disabled channel as a finished frame
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    SENSORSCAN_TIMER->DMAEV &= ~TIMER_DMAEV_TATODMAEN;
+    udma_disable_channel(SENSORSCAN_UDMA_CHANNEL);
+    scan_running = false;
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Publishes a finished frame and re-arms on the other buffer. Call once per timer period
+ */
+void sensorscan_service(void)
+{
+    // Nothing to do until the channel stops itself
+    if ((!scan_running) || udma_is_channel_enabled(SENSORSCAN_UDMA_CHANNEL))
+    {
+        return;
+    }
+
+    // Publish the finished frame, then keep scanning into the other buffer
+    ready_buffer = active_buffer;
+    frame_ready  = true;
+    frame_count++;
+    sensorscan_arm(active_buffer ^ 1);
+}
+
+/**
+ * @brief Decodes the most recent complete frame
+ *
+ * @param p_reading Storage for the 64-bit reading
+ * @return true if a frame was available
+ */
+bool sensorscan_get_reading(uint64_t* p_reading)
+{
+    uint32_t count = 0;
+
+    if (!frame_ready)
+    {
+        return false;
+    }
+
+    // The engine re-arms into the other buffer when a frame finishes, which may be the one being
+    //  decoded. Decode again if a frame finished in the meantime (a frame takes many timer periods)
+    do
+    {
+        count      = frame_count;
+        *p_reading = sensorscan_decode_frame(frames[ready_buffer]);
+    } while (count != frame_count);
+
+    return true;
+}
+
+/**
+ * @brief Gets the number of frames completed since the engine was initialized
+ *
+ * @return The frame count
+ */
+uint32_t sensorscan_get_frame_count(void)
+{
+    return frame_count;
+}
+
+/**
+ * @brief Assembles the raw port samples of a frame into a board reading
+ *
+ * @param frame The raw samples
+ * @return The reading (tile index = file + 8*rank)
+ */
+uint64_t sensorscan_decode_frame(const sensorscan_frame_t frame)
+{
+    uint64_t reading = 0;
+
+    int i = 0;
+    int j = 0;
+    for (i = 0; i < NUMBER_OF_COLS; i++)
+    {
+        for (j = 0; j < NUMBER_OF_ROWS; j++)
+        {
+            if (frame[i][rank_slots[j]] & rank_pins[j])
+            {
+                reading |= BITS64_MASK((i + NUMBER_OF_COLS*j));
+            }
+        }
+    }
+
+    return reading;
+}
+
+/* End sensorscan.c */
@@ -0,0 +1,65 @@
+/**
+ * @file sensorscan.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Optional uDMA scan engine for the reed switch sensor network
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef SENSORSCAN_H_
+#define SENSORSCAN_H_
+
+// Note on the scan engine (enabled with SENSOR_DMA_SCAN in utils.h):
+//  - The gantry timer's timeout requests a uDMA transfer, which steps through a peripheral scatter-gather
+//      task list. One task runs per request:
+//      - Sample the row port 0 DATA register of the selected file
+//      - Sample the row port 1 DATA register of the selected file
+//      - Write select line(s) on select port 0 for the next file
+//      - Write select line(s) on select port 1 for the next file
+//  - Each file therefore settles for a full timer period before it is sampled, and a frame takes
+//      SENSORSCAN_TASKS_PER_FRAME timer periods
+//  - Raw samples land in one of two ping-pong buffers. When a frame finishes, sensorscan_service() (from
+//      the gantry timer ISR) marks it ready and re-arms the channel on the other buffer
+//  - The CPU only decodes completed frames. A frame that finishes during a decode re-arms the channel on
+//      the buffer being decoded, so sensorscan_get_reading() re-checks the frame count and decodes again
+//  - Until the first frame completes, sensornetwork_get_reading() stops the engine and scans directly
+//  - sensorscan_decode_frame() does not touch any registers, so frame assembly can be checked
+//      independently of the hardware
+
+#include "msp.h"
+#include "clock.h"
+#include "gpio.h"
+#include "sensornetwork.h"
+#include "udma.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General scan defines
+#define SENSORSCAN_TIMER                    (TIMER4)    // Shares the gantry timer, which always runs
+#define SENSORSCAN_UDMA_CHANNEL             (0)         // Timer 4A
+#define SENSORSCAN_UDMA_ENCODING            (3)
+#define SENSORSCAN_PORTS_PER_FILE           (2)
+#define SENSORSCAN_TASKS_PER_FILE           (4)
+#define SENSORSCAN_TASKS_PER_FRAME          (SENSORSCAN_TASKS_PER_FILE * NUMBER_OF_COLS)
+
+// Ports sampled/written by the engine (every sensor line must be on one of these)
+#define SENSORSCAN_ROW_PORT_0               (GPIOH)
+#define SENSORSCAN_ROW_PORT_1               (GPIOL)
+#define SENSORSCAN_SELECT_PORT_0            (GPIOD)
+#define SENSORSCAN_SELECT_PORT_1            (GPION)
+
+// Raw samples of one frame, indexed by [file][row port]
+typedef uint8_t sensorscan_frame_t[NUMBER_OF_COLS][SENSORSCAN_PORTS_PER_FILE];
+
+// Public functions
+void sensorscan_init(void);
+void sensorscan_start(void);
+void sensorscan_stop(void);
+void sensorscan_service(void);
+bool sensorscan_get_reading(uint64_t* p_reading);
+uint32_t sensorscan_get_frame_count(void);
+uint64_t sensorscan_decode_frame(const sensorscan_frame_t frame);
+
+#endif /* SENSORSCAN_H_ */
@@ -9,6 +9,8 @@
  */
 
 #include "steppermotors.h"
+#include "isrprofile.h"
+#include "metrics.h"
 
 #ifdef STEPPER_DEBUG
 #include "uart.h"
@@ -552,7 +554,11 @@ static void stepper_update_velocities(uint32_t v_x, uint32_t v_y, uint32_t v_z,
 stepper_rel_command_t* stepper_build_rel_command(int16_t rel_x, int16_t rel_y, int16_t rel_z, uint16_t v_x, uint16_t v_y, uint16_t v_z)
 {
     // The thing to return
-    stepper_rel_command_t* p_command = (stepper_rel_command_t*) malloc(sizeof(stepper_rel_command_t));
+    stepper_rel_command_t* p_command = (stepper_rel_command_t*) memstats_malloc(sizeof(stepper_rel_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &stepper_rel_entry;
@@ -583,7 +589,11 @@ stepper_rel_command_t* stepper_build_rel_command(int16_t rel_x, int16_t rel_y, i
 stepper_chess_command_t* stepper_build_chess_xy_command(chess_file_t file, chess_rank_t rank, uint16_t v_x, uint16_t v_y)
 {
     // The thing to return
-    stepper_chess_command_t* p_command = (stepper_chess_command_t*) malloc(sizeof(stepper_chess_command_t));
+    stepper_chess_command_t* p_command = (stepper_chess_command_t*) memstats_malloc(sizeof(stepper_chess_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &stepper_chess_entry;
@@ -614,7 +624,11 @@ stepper_chess_command_t* stepper_build_chess_xy_command(chess_file_t file, chess
 stepper_chess_command_t* stepper_build_chess_z_command(chess_piece_t piece, uint16_t v_z)
 {
     // The thing to return
-    stepper_chess_command_t* p_command = (stepper_chess_command_t*) malloc(sizeof(stepper_chess_command_t));
+    stepper_chess_command_t* p_command = (stepper_chess_command_t*) memstats_malloc(sizeof(stepper_chess_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &stepper_chess_entry;
@@ -641,7 +655,11 @@ stepper_chess_command_t* stepper_build_chess_z_command(chess_piece_t piece, uint
 stepper_rel_command_t* stepper_build_home_xy_command(void)
 {
     // The thing to return
-    stepper_rel_command_t* p_command = (stepper_rel_command_t*) malloc(sizeof(stepper_rel_command_t));
+    stepper_rel_command_t* p_command = (stepper_rel_command_t*) memstats_malloc(sizeof(stepper_rel_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &stepper_home_entry;
@@ -668,7 +686,11 @@ stepper_rel_command_t* stepper_build_home_xy_command(void)
 stepper_rel_command_t* stepper_build_home_z_command(void)
 {
     // The thing to return
-    stepper_rel_command_t* p_command = (stepper_rel_command_t*) malloc(sizeof(stepper_rel_command_t));
+    stepper_rel_command_t* p_command = (stepper_rel_command_t*) memstats_malloc(sizeof(stepper_rel_command_t));
+    if (p_command == NULL)
+    {
+        return NULL;
+    }
 
     // Functions
     p_command->command.p_entry   = &stepper_home_entry;
@@ -769,6 +791,9 @@ void stepper_chess_entry(command_t* command)
 
     stepper_chess_command_t* p_stepper_command = (stepper_chess_command_t*) command;
 
+    // Time the robot's move (Z moves have no tile)
+    metrics_motion_begin((p_stepper_command->file == FILE_ERROR) ? METRICS_Z : METRICS_TRAVEL);
+
     // X-axis
     if (p_stepper_command->file != FILE_ERROR)
     {
@@ -951,6 +976,7 @@ void stepper_exit(command_t* command)
 
     // Clear the homing flag
     stepper_is_homing = false;
+    metrics_motion_end();
 }
 
 /**
@@ -1011,7 +1037,7 @@ static void stepper_interrupt_activity(stepper_motors_t* p_stepper_motor)
         uart_out_string(PROFILING_CHANNEL, data, 32);
 
         // Delay so this is not spamable (we only transmit strings for testing, so this is not an issue for the actual robot)
-        utils_delay(150000);
+        utils_delay_us(STEPPER_DEBUG_PACING_US);
 #endif
 
         // Update the timer period for smooth motion profiling
@@ -1043,11 +1069,15 @@ static void stepper_interrupt_activity(stepper_motors_t* p_stepper_motor)
  */
 __interrupt void STEPPER_X_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_STEPPER_X);
+
     // Clear the interrupt flag
     clock_clear_interrupt(STEPPER_X_TIMER);
 
     // Perform the stepper interrupt activity
     stepper_interrupt_activity(p_stepper_motor_x);
+
+    ISRPROFILE_EXIT(ISRPROFILE_STEPPER_X);
 }
 
 /**
@@ -1055,11 +1085,15 @@ __interrupt void STEPPER_X_HANDLER(void)
  */
 __interrupt void STEPPER_Y_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_STEPPER_Y);
+
     // Clear the interrupt flag
     clock_clear_interrupt(STEPPER_Y_TIMER);
 
     // Perform the stepper interrupt activity
     stepper_interrupt_activity(p_stepper_motor_y);
+
+    ISRPROFILE_EXIT(ISRPROFILE_STEPPER_Y);
 }
 
 /**
@@ -1067,11 +1101,15 @@ __interrupt void STEPPER_Y_HANDLER(void)
  */
 __interrupt void STEPPER_Z_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_STEPPER_Z);
+
     // Clear the interrupt flag
     clock_clear_interrupt(STEPPER_Z_TIMER);
 
     // Perform the stepper interrupt activity
     stepper_interrupt_activity(p_stepper_motor_z);
+
+    ISRPROFILE_EXIT(ISRPROFILE_STEPPER_Z);
 }
 
 /* End steppermotors.c */
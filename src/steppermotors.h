@@ -58,6 +58,7 @@
 #include <stdio.h>
 
 #define PROFILING_CHANNEL                   (UART_CHANNEL_0)
+#define STEPPER_DEBUG_PACING_US             (5000)      // Gap after each sample so the UART keeps up
 #endif
 
 // General stepper defines
@@ -9,36 +9,72 @@
  */
 
 #include "switch.h"
+#include "isrprofile.h"
 
 // Private functions
 static uint16_t switch_shift_assign(void);
+static uint16_t switch_debounce(uint16_t raw_inputs);
+static void switch_event_push(uint16_t mask, switch_event_type_t type, uint32_t timestamp);
+
+// Declare the switch wiring, indexed by shift
+static const switch_descriptor_t switch_descriptors[NUMBER_OF_SWITCHES] = {
+    {BUTTON_START_PORT,     BUTTON_START_PIN,       BUTTON_START_SHIFT},
+    {BUTTON_RESET_PORT,     BUTTON_RESET_PIN,       BUTTON_RESET_SHIFT},
+    {BUTTON_HOME_PORT,      BUTTON_HOME_PIN,        BUTTON_HOME_SHIFT},
+    {BUTTON_NEXT_TURN_PORT, BUTTON_NEXT_TURN_PIN,   BUTTON_NEXT_TURN_SHIFT},
+    {COLOR_PORT,            COLOR_PIN,              TOGGLE_COLOR_SHIFT},
+    {LIMIT_X_PORT,          LIMIT_X_PIN,            LIMIT_X_SHIFT},
+    {LIMIT_Y_PORT,          LIMIT_Y_PIN,            LIMIT_Y_SHIFT},
+    {LIMIT_Z_PORT,          LIMIT_Z_PIN,            LIMIT_Z_SHIFT},
+    {CAPTURE_PORT,          CAPTURE_PIN,            SWITCH_CAPTURE_SHIFT},
+    {FUTURE_PROOF_1_PORT,   FUTURE_PROOF_1_PIN,     FUTURE_PROOF_1_SHIFT},
+    {FUTURE_PROOF_2_PORT,   FUTURE_PROOF_2_PIN,     FUTURE_PROOF_2_SHIFT},
+    {FUTURE_PROOF_3_PORT,   FUTURE_PROOF_3_PIN,     FUTURE_PROOF_3_SHIFT},
+};
+
+// Distinct ports used by the switches, and which of them each switch is on
+static GPIO_Type* switch_ports[NUMBER_OF_SWITCHES];
+static uint8_t switch_port_index[NUMBER_OF_SWITCHES];
+static uint8_t number_of_switch_ports = 0;
 
 // Declare the switches
 static switch_state_t switches;
 static switch_state_t* p_switches = (&switches);
+static uint8_t integrators[NUMBER_OF_SWITCHES];
+
+// Declare the event ring (head is only written by SWITCH_HANDLER, tail only by the consumer)
+static switch_event_t events[SWITCH_EVENT_QUEUE_SIZE];
+static volatile uint8_t  event_head     = 0;
+static volatile uint8_t  event_tail     = 0;
+static volatile uint32_t dropped_events = 0;
 
 /**
  * @brief Initialize all buttons
  */
 void switch_init(void)
 {
-    // Configure GPIO for all buttons
-    gpio_set_as_input(BUTTON_START_PORT, BUTTON_START_PIN);
-    gpio_set_as_input(BUTTON_RESET_PORT, BUTTON_RESET_PIN);
-    gpio_set_as_input(BUTTON_HOME_PORT, BUTTON_HOME_PIN);
-    gpio_set_as_input(BUTTON_NEXT_TURN_PORT, BUTTON_NEXT_TURN_PIN);
+    int i = 0;
+    int p = 0;
 
-    // Configure GPIO for all toggle switches
-    gpio_set_as_input(COLOR_PORT, COLOR_PIN);
+    // Configure GPIO for all switches, and find the distinct ports to sample
+    number_of_switch_ports = 0;
+    for (i = 0; i < NUMBER_OF_SWITCHES; i++)
+    {
+        const switch_descriptor_t* p_descriptor = &switch_descriptors[i];
+        gpio_set_as_input(p_descriptor->port, p_descriptor->pin);
 
-    // Configure GPIO for all limit switches
-    gpio_set_as_input(LIMIT_PORT, (LIMIT_X_PIN | LIMIT_Y_PIN | LIMIT_Z_PIN));
+        for (p = 0; (p < number_of_switch_ports) && (switch_ports[p] != p_descriptor->port); p++)
+        {
+        }
+        if (p == number_of_switch_ports)
+        {
+            switch_ports[number_of_switch_ports++] = p_descriptor->port;
+        }
+        switch_port_index[i] = p;
+    }
 
-    // Configure GPIO for the capture tile
-    gpio_set_as_input(CAPTURE_PORT, CAPTURE_PIN);
-    
-    // Configure GPIO for all future-proofing switches
-    gpio_set_as_input(FUTURE_PROOF_PORT, (FUTURE_PROOF_1_PIN | FUTURE_PROOF_2_PIN | FUTURE_PROOF_3_PIN));
+    // Stop the motors as soon as the E-stop or a limit switch closes
+    switch_edge_init();
 
     // Start the ISR timer
     clock_start_timer(SWITCH_TIMER);
@@ -54,6 +90,79 @@ uint16_t switch_get_reading(void)
     return p_switches->current_inputs;
 }
 
+/**
+ * @brief Enables the closing-edge interrupts of the E-stop and limit switches
+ */
+void switch_edge_init(void)
+{
+    gpio_set_falling_edge_interrupt(SWITCH_EDGE_M_PORT, SWITCH_EDGE_M_PINS);
+    gpio_set_falling_edge_interrupt(SWITCH_EDGE_K_PORT, SWITCH_EDGE_K_PINS);
+    utils_set_nvic(SWITCH_EDGE_M_INTERRUPT_NUM, SWITCH_EDGE_PRIORITY);
+    utils_set_nvic(SWITCH_EDGE_K_INTERRUPT_NUM, SWITCH_EDGE_PRIORITY);
+}
+
+/**
+ * @brief Gets the switches whose closing edge interrupted on a port, clearing the interrupts.
+ *  A switch only counts if it still reads closed, which rejects short glitches
+ *
+ * @param port One of SWITCH_EDGE_M_PORT or SWITCH_EDGE_K_PORT
+ * @return Switch masks (E_STOP_MASK, LIMIT_X_MASK, ...) of the closed switches that interrupted
+ */
+uint16_t switch_edge_get_pressed(GPIO_Type* port)
+{
+    uint8_t edges = gpio_get_and_clear_interrupt(port);
+
+    // Switches are active-low
+    uint8_t closed = edges & ~((uint8_t) port->DATA);
+    uint16_t pressed = 0;
+
+    // Map the pins back to switches
+    int i = 0;
+    for (i = 0; i < NUMBER_OF_SWITCHES; i++)
+    {
+        if ((switch_descriptors[i].port == port) && (closed & switch_descriptors[i].pin))
+        {
+            pressed |= BITS16_MASK(switch_descriptors[i].shift);
+        }
+    }
+
+    // Only the E-stop and limits are expected to interrupt
+    pressed &= (E_STOP_MASK | LIMIT_MASK);
+
+    return pressed;
+}
+
+/**
+ * @brief Gets the oldest switch event
+ *
+ * @param p_event Storage for the event
+ * @return true if there was an event
+ */
+bool switch_event_pop(switch_event_t* p_event)
+{
+    uint8_t tail = event_tail;
+
+    if (tail == event_head)
+    {
+        return false;
+    }
+
+    // Copy the event out before freeing its slot
+    *p_event   = events[tail & (SWITCH_EVENT_QUEUE_SIZE - 1)];
+    event_tail = tail + 1;
+    return true;
+}
+
+/**
+ * @brief Gets the number of events lost because the ring was full
+ *
+ * @return The dropped event count
+ */
+uint32_t switch_get_dropped_events(void)
+{
+    return dropped_events;
+}
+
 /**
  * @brief Temporary function to test the switch by toggling an LED
  *
@@ -75,36 +184,107 @@ void switch_test(uint16_t mask)
 /* Interrupts */
 
 /**
- * @brief Shifts all switch-related bits to a local ordering
- *  Note: FUTURE_PROOF_3 is currently used as LIMIT_X
+ * @brief Shifts all switch-related bits to a local ordering. Each port is read once
  * 
  * @return The reassigned value for the switch locally
  */
 static uint16_t switch_shift_assign(void)
 {
+    uint8_t port_images[NUMBER_OF_SWITCHES];
     uint16_t switch_reassigned = 0;
-    switch_reassigned |= (gpio_read_input(BUTTON_START_PORT, BUTTON_START_PIN)          << BUTTON_START_SHIFT);
-    switch_reassigned |= (gpio_read_input(BUTTON_RESET_PORT, BUTTON_RESET_PIN)          << BUTTON_RESET_SHIFT);
-    switch_reassigned |= (gpio_read_input(BUTTON_HOME_PORT, BUTTON_HOME_PIN)            << BUTTON_HOME_SHIFT);
-    switch_reassigned |= (gpio_read_input(BUTTON_NEXT_TURN_PORT, BUTTON_NEXT_TURN_PIN)  << BUTTON_NEXT_TURN_SHIFT);
-    switch_reassigned |= (gpio_read_input(COLOR_PORT, COLOR_PIN)                        << TOGGLE_COLOR_SHIFT);
-    switch_reassigned |= (gpio_read_input(FUTURE_PROOF_PORT, FUTURE_PROOF_3_PIN)        << LIMIT_X_SHIFT);
-    switch_reassigned |= (gpio_read_input(LIMIT_PORT, LIMIT_Y_PIN)                      << LIMIT_Y_SHIFT);
-    switch_reassigned |= (gpio_read_input(LIMIT_PORT, LIMIT_Z_PIN)                      << LIMIT_Z_SHIFT);
-    switch_reassigned |= (gpio_read_input(CAPTURE_PORT, CAPTURE_PIN)                    << SWITCH_CAPTURE_SHIFT);
-    switch_reassigned |= (gpio_read_input(FUTURE_PROOF_PORT, FUTURE_PROOF_1_PIN)        << FUTURE_PROOF_1_SHIFT);
-    switch_reassigned |= (gpio_read_input(FUTURE_PROOF_PORT, FUTURE_PROOF_2_PIN)        << FUTURE_PROOF_2_SHIFT);
-    switch_reassigned |= (gpio_read_input(LIMIT_PORT, LIMIT_X_PIN)                      << FUTURE_PROOF_3_SHIFT);
+    int i = 0;
+
+    // Image every port
+    for (i = 0; i < number_of_switch_ports; i++)
+    {
+        port_images[i] = (uint8_t) switch_ports[i]->DATA;
+    }
+
+    // Move each switch's pin to its shift
+    for (i = 0; i < NUMBER_OF_SWITCHES; i++)
+    {
+        if (port_images[switch_port_index[i]] & switch_descriptors[i].pin)
+        {
+            switch_reassigned |= BITS16_MASK(switch_descriptors[i].shift);
+        }
+    }
 
     // Apply an inversion mask to the active-low switches
     return (switch_reassigned ^ SWITCH_MASK);
 }
 
+/**
+ * @brief Runs every switch's debounce integrator on a new sample
+ *
+ * @param raw_inputs The raw (inverted to active-high) switch sample
+ * @return The debounced switch levels
+ */
+static uint16_t switch_debounce(uint16_t raw_inputs)
+{
+    uint16_t debounced = p_switches->current_inputs;
+
+    int i = 0;
+    for (i = 0; i < NUMBER_OF_SWITCHES; i++)
+    {
+        // Integrate towards the raw level
+        if (raw_inputs & BITS16_MASK(i))
+        {
+            if (integrators[i] < SWITCH_DEBOUNCE_TICKS)
+            {
+                integrators[i]++;
+            }
+        }
+        else if (integrators[i] > 0)
+        {
+            integrators[i]--;
+        }
+
+        // Only change state at the ends of the integrator
+        if (integrators[i] == SWITCH_DEBOUNCE_TICKS)
+        {
+            debounced |= BITS16_MASK(i);
+        }
+        else if (integrators[i] == 0)
+        {
+            debounced &= ~BITS16_MASK(i);
+        }
+    }
+
+    return debounced;
+}
+
+/**
+ * @brief Adds an event to the ring, dropping it if the ring is full
+ *
+ * @param mask Which switch
+ * @param type Pressed or released
+ * @param timestamp Cycle count of the edge
+ */
+static void switch_event_push(uint16_t mask, switch_event_type_t type, uint32_t timestamp)
+{
+    uint8_t head = event_head;
+
+    if ((uint8_t) (head - event_tail) >= SWITCH_EVENT_QUEUE_SIZE)
+    {
+        dropped_events++;
+        return;
+    }
+
+    // Fill the slot before publishing it
+    switch_event_t* p_event = &events[head & (SWITCH_EVENT_QUEUE_SIZE - 1)];
+    p_event->timestamp = timestamp;
+    p_event->mask      = mask;
+    p_event->type      = type;
+    event_head         = head + 1;
+}
+
 /**
  * @brief Interrupt handler for the switch module
  */
 __interrupt void SWITCH_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_SWITCH);
+
     // Clear the interrupt flag
     clock_clear_interrupt(SWITCH_TIMER);
 
@@ -112,11 +292,31 @@ __interrupt void SWITCH_HANDLER(void)
     switch_vport.image          = switch_shift_assign();
 
     // Update the switch transition information
-    p_switches->current_inputs  = switch_vport.image;
+    p_switches->current_inputs  = switch_debounce(switch_vport.image);
     p_switches->edges           = (p_switches->current_inputs ^ p_switches->previous_inputs);
     p_switches->pos_transitions = (p_switches->current_inputs & p_switches->edges);
     p_switches->neg_transitions = ((~p_switches->current_inputs) & p_switches->edges);
     p_switches->previous_inputs = p_switches->current_inputs;
+
+    // Queue an event for every debounced edge
+    if (p_switches->edges)
+    {
+        uint32_t timestamp = utils_get_cycles();
+        int i = 0;
+        for (i = 0; i < NUMBER_OF_SWITCHES; i++)
+        {
+            if (p_switches->pos_transitions & BITS16_MASK(i))
+            {
+                switch_event_push(BITS16_MASK(i), SWITCH_PRESSED, timestamp);
+            }
+            else if (p_switches->neg_transitions & BITS16_MASK(i))
+            {
+                switch_event_push(BITS16_MASK(i), SWITCH_RELEASED, timestamp);
+            }
+        }
+    }
+
+    ISRPROFILE_EXIT(ISRPROFILE_SWITCH);
 }
 
 /* End buttons.c */
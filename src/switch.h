@@ -12,22 +12,31 @@
 #define SWITCHES_H_
 
 // Note on switches: 
-//  - Assumes all switches are on the same physical port
-//  - Creates a virtual port to access the physical port via imaging
+//  - Each switch is described by a port/pin/shift entry in a compile-time descriptor table (switch.c)
+//  - Every tick, each port used by a switch is read once, then the images are mapped into a virtual port
 //  - The SWITCH_HANDLER reads the virtual port and maps it to a local bitfield
 //  - To move switches to different GPIO, change the GPIO macros below, no other changes required
+//  - Each switch has a debounce integrator: it must read the same for SWITCH_DEBOUNCE_TICKS samples to change
+//  - Every debounced press/release is pushed as a timestamped event into a single-producer (SWITCH_HANDLER),
+//      single-consumer ring, so each edge is handled exactly once. switch_get_reading() gives the debounced levels
+//  - The E-stop and limit switches also interrupt on their closing edge, so motors stop without waiting
+//      for the timers. The polled readings remain the source of truth (and a watchdog for missed edges)
 
 #include "msp.h"
 #include "gpio.h"
 #include "utils.h"
 #include "clock.h"
 #include <stdint.h>
+#include <stdbool.h>
 
 // General switch macros
 #define SWITCH_TIMER                        (TIMER3)
 #define SWITCH_HANDLER                      (TIMER3A_IRQHandler)
 #define SWITCH_TEST_PORT                    (GPION)
 #define SWITCH_TEST_PIN                     (GPIO_PIN_0)
+#define NUMBER_OF_SWITCHES                  (12)
+#define SWITCH_DEBOUNCE_TICKS               (3)         // Consecutive agreeing samples (600us) to change state
+#define SWITCH_EVENT_QUEUE_SIZE             (16)        // Must be a power of 2
 
 // Button GPIO macros
 #define BUTTON_START_PORT                   (GPIOF)
@@ -44,21 +53,36 @@
 #define COLOR_PIN                           (GPIO_PIN_6)
 
 // Limit switch GPIO macros
-#define LIMIT_PORT                          (GPIOK)
+#define LIMIT_X_PORT                        (GPIOM)
 #define LIMIT_X_PIN                         (GPIO_PIN_2)
+#define LIMIT_Y_PORT                        (GPIOK)
 #define LIMIT_Y_PIN                         (GPIO_PIN_1)
+#define LIMIT_Z_PORT                        (GPIOK)
 #define LIMIT_Z_PIN                         (GPIO_PIN_0)
 
 // Capture tile GPIO macros
 #define CAPTURE_PORT                        (GPIOP)
 #define CAPTURE_PIN                         (GPIO_PIN_1)
 
-// Future-proofing switch GPIO macros
-#define FUTURE_PROOF_PORT                   (GPIOM)
+// Future-proofing switch GPIO macros (FUTURE_PROOF_2 is the E-stop)
+#define FUTURE_PROOF_1_PORT                 (GPIOM)
 #define FUTURE_PROOF_1_PIN                  (GPIO_PIN_1)
+#define FUTURE_PROOF_2_PORT                 (GPIOM)
 #define FUTURE_PROOF_2_PIN                  (GPIO_PIN_0)
+#define FUTURE_PROOF_3_PORT                 (GPIOK)
 #define FUTURE_PROOF_3_PIN                  (GPIO_PIN_2)
 
+// Edge interrupt macros (E-stop and limits)
+#define SWITCH_EDGE_M_PORT                  (GPIOM)
+#define SWITCH_EDGE_M_PINS                  (FUTURE_PROOF_2_PIN | LIMIT_X_PIN)
+#define SWITCH_EDGE_M_HANDLER               (GPIOM_IRQHandler)
+#define SWITCH_EDGE_M_INTERRUPT_NUM         (GPIOM_IRQn)
+#define SWITCH_EDGE_K_PORT                  (GPIOK)
+#define SWITCH_EDGE_K_PINS                  (LIMIT_Y_PIN | LIMIT_Z_PIN)
+#define SWITCH_EDGE_K_HANDLER               (GPIOK_IRQHandler)
+#define SWITCH_EDGE_K_INTERRUPT_NUM         (GPIOK_IRQn)
+#define SWITCH_EDGE_PRIORITY                (0)         // Above every timer
+
 // Shifts for where the bits will end up in the virtual port
 #define BUTTON_START_SHIFT                  (0)
 #define BUTTON_RESET_SHIFT                  (1)
@@ -104,12 +128,36 @@ typedef struct {
     uint16_t previous_inputs;
 } switch_state_t;
 
+// Describes where a switch is wired and where it lands in the virtual port
+typedef struct {
+    GPIO_Type* port;
+    uint8_t pin;
+    uint8_t shift;
+} switch_descriptor_t;
+
+// Switch event types
+typedef enum switch_event_type_t {
+    SWITCH_PRESSED,
+    SWITCH_RELEASED,
+} switch_event_type_t;
+
+// A single debounced switch edge
+typedef struct {
+    uint32_t timestamp;                 // Cycle count when the edge was debounced
+    uint16_t mask;                      // Which switch (one of the user-access masks)
+    switch_event_type_t type;
+} switch_event_t;
+
 // Virtual port for the switches
 union utils_vport16_t switch_vport;
 
 // Public functions
 void switch_init(void);
 uint16_t switch_get_reading(void);
+bool switch_event_pop(switch_event_t* p_event);
+uint32_t switch_get_dropped_events(void);
 void switch_test(uint16_t mask);
+void switch_edge_init(void);
+uint16_t switch_edge_get_pressed(GPIO_Type* port);
 
 #endif /* SWITCHES_H_ */
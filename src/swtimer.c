@@ -0,0 +1,404 @@
+/**
+ * @file swtimer.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Software timers multiplexed on one one-shot hardware timer
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "swtimer.h"
+#include "isrprofile.h"
+
+// Private functions
+static swtimer_t** swtimer_get_list(swtimer_t* p_timer);
+static void swtimer_insert(swtimer_t* p_timer);
+static void swtimer_remove(swtimer_t* p_timer);
+static void swtimer_cascade(uint8_t level, uint8_t slot);
+static bool swtimer_get_next_event(uint32_t* p_tick);
+static void swtimer_program(void);
+
+// Level value of a timer that has been taken off the wheel to expire
+#define SWTIMER_EXPIRING                    (SWTIMER_LEVELS)
+
+// Declare the wheel
+static swtimer_t* wheel[SWTIMER_LEVELS][SWTIMER_SLOTS];
+static uint32_t occupied[SWTIMER_LEVELS];   // Bit n is set if slot n holds a timer
+static swtimer_t* p_expiring = 0;           // Timers being expired by the interrupt
+static uint32_t wheel_tick   = 0;           // Next tick the wheel will process
+
+/**
+ * @brief Initialize the software timers (call after clock_timer5a_init() and timebase_init())
+ */
+void swtimer_init(void)
+{
+    uint8_t i = 0;
+    uint8_t j = 0;
+
+    for (i = 0; i < SWTIMER_LEVELS; i++)
+    {
+        for (j = 0; j < SWTIMER_SLOTS; j++)
+        {
+            wheel[i][j] = 0;
+        }
+        occupied[i] = 0;
+    }
+    p_expiring = 0;
+    wheel_tick = swtimer_get_ticks();
+}
+
+/**
+ * @brief Prepares a timer (it starts disarmed)
+ *
+ * @param p_timer The timer
+ * @param callback Function called from the interrupt at each deadline
+ * @param p_context Passed to the callback
+ */
+void swtimer_setup(swtimer_t* p_timer, swtimer_callback_t callback, void* p_context)
+{
+    p_timer->p_next    = 0;
+    p_timer->p_prev    = 0;
+    p_timer->callback  = callback;
+    p_timer->p_context = p_context;
+    p_timer->expiry    = 0;
+    p_timer->period    = 0;
+    p_timer->level     = 0;
+    p_timer->slot      = 0;
+    p_timer->armed     = false;
+}
+
+/**
+ * @brief Arms (or re-arms) a timer. The callback runs no earlier than delay_us from now
+ *
+ * @param p_timer The timer
+ * @param delay_us Time until the first deadline in microseconds (rounded up to a tick boundary)
+ * @param period_us Time between later deadlines in microseconds (0 for one-shot)
+ */
+void swtimer_arm(swtimer_t* p_timer, uint32_t delay_us, uint32_t period_us)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint64_t now     = timebase_now_cycles();
+
+    __disable_irq();
+
+    // Re-arming moves the timer
+    if (p_timer->armed)
+    {
+        swtimer_remove(p_timer);
+    }
+
+    // An empty wheel may have fallen behind, so catch it up first
+    if ((occupied[0] | occupied[1] | occupied[2]) == 0)
+    {
+        wheel_tick = (uint32_t) (now / SWTIMER_TICK_CYCLES);
+    }
+
+    // First tick boundary at or after the deadline
+    p_timer->expiry = (uint32_t) ((now + ((uint64_t) delay_us * TIMEBASE_CYCLES_PER_US) + SWTIMER_TICK_CYCLES - 1) / SWTIMER_TICK_CYCLES);
+    p_timer->period = (period_us + SWTIMER_TICK_US - 1) / SWTIMER_TICK_US;
+    p_timer->armed  = true;
+    swtimer_insert(p_timer);
+    swtimer_program();
+
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Disarms a timer. Its callback will not run again until it is re-armed
+ *
+ * @param p_timer The timer
+ */
+void swtimer_cancel(swtimer_t* p_timer)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    if (p_timer->armed)
+    {
+        swtimer_remove(p_timer);
+        p_timer->armed = false;
+    }
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Checks if a timer is armed
+ *
+ * @param p_timer The timer
+ * @return true if the timer's callback is still due
+ */
+bool swtimer_is_armed(swtimer_t* p_timer)
+{
+    return p_timer->armed;
+}
+
+/**
+ * @brief Gets the current time in ticks
+ *
+ * @return The tick count (wraps every ~49 days)
+ */
+uint32_t swtimer_get_ticks(void)
+{
+    return (uint32_t) (timebase_now_cycles() / SWTIMER_TICK_CYCLES);
+}
+
+/**
+ * @brief Helper function to find the list a timer is on
+ *
+ * @param p_timer The timer
+ * @return Pointer to the head of the list
+ */
+static swtimer_t** swtimer_get_list(swtimer_t* p_timer)
+{
+    if (p_timer->level == SWTIMER_EXPIRING)
+    {
+        return &p_expiring;
+    }
+    return &wheel[p_timer->level][p_timer->slot];
+}
+
+/**
+ * @brief Helper function to place a timer on the wheel by its deadline (interrupts must be masked)
+ *
+ * @param p_timer The timer
+ */
+static void swtimer_insert(swtimer_t* p_timer)
+{
+    uint32_t expiry = p_timer->expiry;
+    int32_t  delta  = (int32_t) (expiry - wheel_tick);
+
+    // A deadline that has already passed expires as soon as possible
+    if (delta < 0)
+    {
+        expiry = wheel_tick;
+        delta  = 0;
+    }
+
+    // Pick the level by distance, and the slot by the deadline's digit at that level
+    if (delta < SWTIMER_SLOTS)
+    {
+        p_timer->level = 0;
+        p_timer->slot  = expiry & SWTIMER_SLOT_MASK;
+    }
+    else if (delta < (SWTIMER_SLOTS * SWTIMER_SLOTS))
+    {
+        p_timer->level = 1;
+        p_timer->slot  = (expiry >> SWTIMER_SLOT_BITS) & SWTIMER_SLOT_MASK;
+    }
+    else
+    {
+        // Past the end of the wheel, park in the furthest slot (it comes back here when that slot cascades)
+        if (delta >= (SWTIMER_SLOTS * SWTIMER_SLOTS * SWTIMER_SLOTS))
+        {
+            expiry = wheel_tick + (SWTIMER_SLOTS * SWTIMER_SLOTS * SWTIMER_SLOTS) - 1;
+        }
+        p_timer->level = 2;
+        p_timer->slot  = (expiry >> (2 * SWTIMER_SLOT_BITS)) & SWTIMER_SLOT_MASK;
+    }
+
+    // Push onto the front of the slot
+    swtimer_t** pp_head = &wheel[p_timer->level][p_timer->slot];
+    p_timer->p_prev = 0;
+    p_timer->p_next = *pp_head;
+    if (*pp_head)
+    {
+        (*pp_head)->p_prev = p_timer;
+    }
+    *pp_head = p_timer;
+    occupied[p_timer->level] |= BITS32_MASK(p_timer->slot);
+}
+
+/**
+ * @brief Helper function to take a timer off its list (interrupts must be masked)
+ *
+ * @param p_timer The timer
+ */
+static void swtimer_remove(swtimer_t* p_timer)
+{
+    swtimer_t** pp_head = swtimer_get_list(p_timer);
+
+    if (p_timer->p_prev)
+    {
+        p_timer->p_prev->p_next = p_timer->p_next;
+    }
+    else
+    {
+        *pp_head = p_timer->p_next;
+    }
+    if (p_timer->p_next)
+    {
+        p_timer->p_next->p_prev = p_timer->p_prev;
+    }
+    p_timer->p_next = 0;
+    p_timer->p_prev = 0;
+
+    if ((p_timer->level != SWTIMER_EXPIRING) && (*pp_head == 0))
+    {
+        occupied[p_timer->level] &= ~BITS32_MASK(p_timer->slot);
+    }
+}
+
+/**
+ * @brief Helper function to move every timer in a slot down the wheel (interrupts must be masked)
+ *
+ * @param level The level of the slot
+ * @param slot The slot
+ */
+static void swtimer_cascade(uint8_t level, uint8_t slot)
+{
+    swtimer_t* p_timer = wheel[level][slot];
+
+    wheel[level][slot] = 0;
+    occupied[level] &= ~BITS32_MASK(slot);
+
+    while (p_timer)
+    {
+        swtimer_t* p_next = p_timer->p_next;
+        swtimer_insert(p_timer);
+        p_timer = p_next;
+    }
+}
+
+/**
+ * @brief Helper function to find the next tick with work to do: an occupied level 0 slot, or a level 0
+ *        wrap that cascades the upper levels (interrupts must be masked)
+ *
+ * @param p_tick Storage for the tick
+ * @return Whether any timer is armed
+ */
+static bool swtimer_get_next_event(uint32_t* p_tick)
+{
+    uint32_t index   = wheel_tick & SWTIMER_SLOT_MASK;
+    uint32_t base    = wheel_tick - index;
+    uint32_t pending = 0;
+
+    if ((occupied[0] | occupied[1] | occupied[2]) == 0)
+    {
+        return false;
+    }
+
+    // Cascades happen first
+    if ((index == 0) && ((occupied[1] | occupied[2]) != 0))
+    {
+        *p_tick = wheel_tick;
+        return true;
+    }
+
+    // Lowest occupied slot at or after the current one (the rest wait for the wrap)
+    pending = occupied[0] & (0xFFFFFFFF << index);
+    if (pending)
+    {
+        *p_tick = base + __CLZ(__RBIT(pending));
+    }
+    else
+    {
+        *p_tick = base + SWTIMER_SLOTS;
+    }
+    return true;
+}
+
+/**
+ * @brief Helper function to load the hardware timer for the next event, or stop it (interrupts must be masked)
+ */
+static void swtimer_program(void)
+{
+    uint32_t next_tick = 0;
+    uint32_t load      = SWTIMER_MIN_LOAD_CYCLES;
+
+    if (!swtimer_get_next_event(&next_tick))
+    {
+        clock_stop_timer(SWTIMER_TIMER);
+        return;
+    }
+
+    // Count down to the start of the event's tick
+    uint64_t now   = timebase_now_cycles();
+    int32_t  delta = (int32_t) (next_tick - (uint32_t) (now / SWTIMER_TICK_CYCLES));
+    if (delta > 0)
+    {
+        load = (((uint32_t) delta) * SWTIMER_TICK_CYCLES) - ((uint32_t) (now % SWTIMER_TICK_CYCLES));
+    }
+    if (load < SWTIMER_MIN_LOAD_CYCLES)
+    {
+        load = SWTIMER_MIN_LOAD_CYCLES;
+    }
+
+    clock_set_timer_period(SWTIMER_TIMER, load);
+    clock_reset_timer_value(SWTIMER_TIMER);
+    clock_start_timer(SWTIMER_TIMER);
+}
+
+/* Interrupts */
+
+/**
+ * @brief Runs every event that is due, then loads the timer for the next one
+ */
+__interrupt void SWTIMER_HANDLER(void)
+{
+    ISRPROFILE_ENTER(ISRPROFILE_SWTIMER);
+
+    uint32_t primask  = __get_PRIMASK();
+    uint32_t now_tick = swtimer_get_ticks();
+    uint32_t next_tick = 0;
+
+    // Clear the interrupt flag
+    clock_clear_interrupt(SWTIMER_TIMER);
+
+    __disable_irq();
+    while (swtimer_get_next_event(&next_tick) && ((int32_t) (next_tick - now_tick) <= 0))
+    {
+        uint8_t slot = next_tick & SWTIMER_SLOT_MASK;
+        wheel_tick = next_tick;
+
+        // Crossing a level 0 wrap brings the next level 1 slot (and level 2, on its wrap) down
+        if (slot == 0)
+        {
+            uint32_t block = next_tick >> SWTIMER_SLOT_BITS;
+            if ((block & SWTIMER_SLOT_MASK) == 0)
+            {
+                swtimer_cascade(2, (block >> SWTIMER_SLOT_BITS) & SWTIMER_SLOT_MASK);
+            }
+            swtimer_cascade(1, block & SWTIMER_SLOT_MASK);
+        }
+
+        // Everything in the slot is due. Take the slot off the wheel first, so re-armed timers land elsewhere
+        p_expiring = wheel[0][slot];
+        wheel[0][slot] = 0;
+        occupied[0] &= ~BITS32_MASK(slot);
+        swtimer_t* p_timer = p_expiring;
+        while (p_timer)
+        {
+            p_timer->level = SWTIMER_EXPIRING;
+            p_timer = p_timer->p_next;
+        }
+        wheel_tick = next_tick + 1;
+
+        // Expire each one (a callback may cancel the ones still waiting)
+        while (p_expiring)
+        {
+            p_timer = p_expiring;
+            swtimer_remove(p_timer);
+            if (p_timer->period)
+            {
+                p_timer->expiry += p_timer->period;
+                swtimer_insert(p_timer);
+            }
+            else
+            {
+                p_timer->armed = false;
+            }
+
+            __set_PRIMASK(primask);
+            p_timer->callback(p_timer->p_context);
+            __disable_irq();
+        }
+    }
+
+    swtimer_program();
+    __set_PRIMASK(primask);
+
+    ISRPROFILE_EXIT(ISRPROFILE_SWTIMER);
+}
+
+/* End swtimer.c */
@@ -0,0 +1,74 @@
+/**
+ * @file swtimer.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Software timers multiplexed on one one-shot hardware timer
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef SWTIMER_H_
+#define SWTIMER_H_
+
+// Note on the software timers:
+//  - Any number of timers share SWTIMER_TIMER. Each timer calls its callback (from SWTIMER_HANDLER) once
+//      its deadline passes, then stops, or re-arms itself if it has a period
+//  - Deadlines are kept in a hierarchical timing wheel of SWTIMER_LEVELS levels with SWTIMER_SLOTS slots each:
+//      - Level 0: one slot per tick (deadlines less than SWTIMER_SLOTS ticks away)
+//      - Level 1: one slot per SWTIMER_SLOTS ticks
+//      - Level 2: one slot per SWTIMER_SLOTS^2 ticks (anything further is parked in the last slot)
+//      - Each time the wheel crosses a slot boundary of a level, the timers in that slot move down a level
+//  - Arming, cancelling, and expiring a timer are all O(1). A bitmap of occupied slots finds the next
+//      deadline without scanning
+//  - The hardware timer runs in one-shot mode and is loaded for the next event only (the next occupied
+//      level 0 slot, or the next level 0 wrap while anything sits in the upper levels). With nothing armed,
+//      it does not run at all
+//  - Callbacks run in the interrupt, so they should only set flags or touch pins. A callback may arm or
+//      cancel timers, including its own
+//  - Timer structures belong to the caller and must stay valid while armed (e.g., static, or inside a command
+//      that cancels it in its exit function)
+
+#include "msp.h"
+#include "clock.h"
+#include "timebase.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General software timer defines
+#define SWTIMER_TIMER                       (TIMER5)
+#define SWTIMER_HANDLER                     (TIMER5A_IRQHandler)
+#define SWTIMER_TICK_US                     (1000)      // Resolution of every deadline
+#define SWTIMER_TICK_CYCLES                 (SWTIMER_TICK_US * TIMEBASE_CYCLES_PER_US)
+#define SWTIMER_LEVELS                      (3)
+#define SWTIMER_SLOT_BITS                   (5)
+#define SWTIMER_SLOTS                       (1 << SWTIMER_SLOT_BITS)    // Must match the bitmap width
+#define SWTIMER_SLOT_MASK                   (SWTIMER_SLOTS - 1)
+#define SWTIMER_MIN_LOAD_CYCLES             (120)       // Shortest one-shot, so a late event still interrupts
+
+// Callback type
+typedef void (*swtimer_callback_t)(void* p_context);
+
+// Software timer
+typedef struct swtimer_t {
+    struct swtimer_t* p_next;                       // Neighbors in the wheel slot
+    struct swtimer_t* p_prev;
+    swtimer_callback_t callback;
+    void* p_context;                                // Passed to the callback
+    uint32_t expiry;                                // Deadline (in ticks)
+    uint32_t period;                                // Ticks between repeats (0 for one-shot)
+    uint8_t level;                                  // Wheel position while armed
+    uint8_t slot;
+    volatile bool armed;
+} swtimer_t;
+
+// Public functions
+void swtimer_init(void);
+void swtimer_setup(swtimer_t* p_timer, swtimer_callback_t callback, void* p_context);
+void swtimer_arm(swtimer_t* p_timer, uint32_t delay_us, uint32_t period_us);
+void swtimer_cancel(swtimer_t* p_timer);
+bool swtimer_is_armed(swtimer_t* p_timer);
+uint32_t swtimer_get_ticks(void);
+
+#endif /* SWTIMER_H_ */
@@ -0,0 +1,91 @@
+/**
+ * @file timebase.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Monotonic 64-bit timebase built on the DWT cycle counter
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "timebase.h"
+
+// Private variables
+static volatile uint32_t high_word = 0;     // Number of times the counter has wrapped
+static volatile uint32_t last_low  = 0;     // Counter value at the previous read
+
+/**
+ * @brief Initialize the timebase (call after clock_sys_init(), which starts the cycle counter)
+ */
+void timebase_init(void)
+{
+    high_word = 0;
+    last_low  = utils_get_cycles();
+}
+
+/**
+ * @brief Catches a counter wrap. Call at least once every ~35s (done from the gantry timer ISR)
+ */
+void timebase_service(void)
+{
+    (void) timebase_now_cycles();
+}
+
+/**
+ * @brief Gets the number of core clock cycles since the cycle counter was started
+ *
+ * @return The 64-bit cycle count
+ */
+uint64_t timebase_now_cycles(void)
+{
+    uint32_t primask = __get_PRIMASK();
+    uint32_t low     = 0;
+    uint64_t now     = 0;
+
+    // The wrap check and update must not be split by another reader
+    __disable_irq();
+    low = utils_get_cycles();
+    if (low < last_low)
+    {
+        high_word++;
+    }
+    last_low = low;
+    now = (((uint64_t) high_word) << 32) | low;
+    __set_PRIMASK(primask);
+
+    return now;
+}
+
+/**
+ * @brief Gets the number of microseconds since the cycle counter was started
+ *
+ * @return The 64-bit time in microseconds
+ */
+uint64_t timebase_now_us(void)
+{
+    return timebase_cycles_to_us(timebase_now_cycles());
+}
+
+/**
+ * @brief Converts a number of core clock cycles to microseconds (rounded down)
+ *
+ * @param cycles Number of cycles
+ * @return Number of microseconds
+ */
+uint64_t timebase_cycles_to_us(uint64_t cycles)
+{
+    return cycles / TIMEBASE_CYCLES_PER_US;
+}
+
+/**
+ * @brief Converts a number of microseconds to core clock cycles
+ *
+ * @param us Number of microseconds
+ * @return Number of cycles
+ */
+uint64_t timebase_us_to_cycles(uint64_t us)
+{
+    return us * TIMEBASE_CYCLES_PER_US;
+}
+
+/* End timebase.c */
@@ -0,0 +1,40 @@
+/**
+ * @file timebase.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Monotonic 64-bit timebase built on the DWT cycle counter
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+// Note on the timebase:
+//  - The DWT cycle counter (started by clock_sys_init()) counts core clock cycles, but it is only 32 bits
+//      wide and wraps every ~35s at 120MHz. It has no overflow interrupt
+//  - Every read compares the counter against the previous read. A smaller value means it wrapped, so the
+//      upper 32 bits are incremented. Reads are done with interrupts masked, so any context may call them
+//  - timebase_service() is called from the gantry timer ISR (which always runs), so a wrap is never missed
+//      even if nothing else reads the time for a while
+//  - Timestamps never go backwards and do not wrap in practice (2^64 cycles at 120MHz is ~4800 years)
+
+#include "msp.h"
+#include "clock.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General timebase defines
+#define TIMEBASE_CYCLES_PER_US              (SYSCLOCK_FREQUENCY / 1000000)
+#define TIMEBASE_CYCLES_PER_MS              (SYSCLOCK_FREQUENCY / 1000)
+
+// Public functions
+void timebase_init(void);
+void timebase_service(void);
+uint64_t timebase_now_cycles(void);
+uint64_t timebase_now_us(void);
+uint64_t timebase_cycles_to_us(uint64_t cycles);
+uint64_t timebase_us_to_cycles(uint64_t us);
+
+#endif /* TIMEBASE_H_ */
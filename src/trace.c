@@ -0,0 +1,189 @@
+/**
+ * @file trace.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Records the lifecycle of every command run by main() into a RAM ring
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "trace.h"
+#include <string.h>
+
+// Private functions
+static uint32_t trace_now_us(void);
+
+// Declare the ring (written by main() only, read by the debug port)
+static trace_record_t ring[TRACE_RING_SIZE];
+static volatile uint32_t head    = 0;               // Records ever stored
+static volatile uint32_t dropped = 0;
+static volatile bool dumping     = false;
+
+// Record being built for the running command
+static trace_record_t current;
+static uint16_t sequence = 0;
+
+// Dump position
+static uint32_t dump_first = 0;
+static uint16_t dump_count = 0;
+
+/**
+ * @brief Starts the record of a command (just before its entry function)
+ *
+ * @param p_command The command
+ */
+void trace_command_begin(command_t* p_command)
+{
+    memset(&current, 0, sizeof(current));
+    current.command  = (uint32_t) (uintptr_t) p_command->p_entry;
+    current.sequence = sequence++;
+    current.entry_us = trace_now_us();
+}
+
+/**
+ * @brief Marks the end of the entry function
+ */
+void trace_command_action(void)
+{
+    current.action_us = trace_now_us();
+}
+
+/**
+ * @brief Counts one action call
+ */
+void trace_command_iteration(void)
+{
+    current.iterations++;
+}
+
+/**
+ * @brief Marks the end of the action loop (just before the exit function)
+ */
+void trace_command_exit(void)
+{
+    current.exit_us = trace_now_us();
+    if (sys_reset)
+    {
+        current.flags |= TRACE_FLAG_RESET;
+    }
+    if (sys_limit)
+    {
+        current.flags |= TRACE_FLAG_LIMIT;
+    }
+}
+
+/**
+ * @brief Marks the end of the exit function and stores the record
+ */
+void trace_command_end(void)
+{
+    current.end_us = trace_now_us();
+
+    // Leave the ring alone while it is being dumped
+    if (dumping)
+    {
+        dropped++;
+        return;
+    }
+
+    // Fill the slot before publishing it
+    ring[head & TRACE_RING_MASK] = current;
+    head++;
+}
+
+/**
+ * @brief Discards every record
+ */
+void trace_clear(void)
+{
+    uint32_t primask = __get_PRIMASK();
+
+    __disable_irq();
+    head    = 0;
+    dropped = 0;
+    __set_PRIMASK(primask);
+}
+
+/**
+ * @brief Freezes the ring for a dump (the 't' debug command)
+ */
+void trace_dump_start(void)
+{
+    uint32_t stored = head;
+
+    // A record may be half written into the oldest slot of a full ring, so leave that one out
+    dumping    = true;
+    dump_count = (stored < TRACE_RING_SIZE) ? stored : (TRACE_RING_SIZE - 1);
+    dump_first = stored - dump_count;
+}
+
+/**
+ * @brief Writes one piece of the binary dump (a debug port writer): the header first, then
+ *        TRACE_RECORDS_PER_WRITE records at a time. Unfreezes the ring once done
+ *
+ * @param index Piece number
+ * @param p_buffer Storage for the piece
+ * @param size Size of the buffer
+ * @return The piece length (0 once the dump is done)
+ */
+uint8_t trace_write_dump(uint16_t index, uint8_t* p_buffer, uint8_t size)
+{
+    uint16_t record_size = sizeof(trace_record_t);
+    uint16_t first = 0;
+    uint16_t count = 0;
+
+    if (index == 0)
+    {
+        uint32_t now_us = trace_now_us();
+        uint32_t lost   = dropped;
+
+        p_buffer[0] = 'T';
+        p_buffer[1] = 'R';
+        p_buffer[2] = 'C';
+        p_buffer[3] = TRACE_FORMAT_VERSION;
+        memcpy(&p_buffer[4],  &dump_count,  sizeof(uint16_t));
+        memcpy(&p_buffer[6],  &record_size, sizeof(uint16_t));
+        memcpy(&p_buffer[8],  &lost,        sizeof(uint32_t));
+        memcpy(&p_buffer[12], &now_us,      sizeof(uint32_t));
+        return TRACE_HEADER_SIZE;
+    }
+
+    first = (index - 1) * TRACE_RECORDS_PER_WRITE;
+    count = (first < dump_count) ? (dump_count - first) : 0;
+    if (count > TRACE_RECORDS_PER_WRITE)
+    {
+        count = TRACE_RECORDS_PER_WRITE;
+    }
+    if ((count * record_size) > size)
+    {
+        count = size / record_size;
+    }
+
+    // Done
+    if (count == 0)
+    {
+        dumping = false;
+        return 0;
+    }
+
+    uint16_t i = 0;
+    for (i = 0; i < count; i++)
+    {
+        memcpy(&p_buffer[i * record_size], &ring[(dump_first + first + i) & TRACE_RING_MASK], record_size);
+    }
+
+    return count * record_size;
+}
+
+/**
+ * @brief Gets the current time for a record
+ *
+ * @return The low 32 bits of the timebase, in microseconds
+ */
+static uint32_t trace_now_us(void)
+{
+    return (uint32_t) timebase_now_us();
+}
+
+/* End trace.c */
@@ -0,0 +1,85 @@
+/**
+ * @file trace.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Records the lifecycle of every command run by main() into a RAM ring
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef TRACE_H_
+#define TRACE_H_
+
+// Note on command tracing (enabled with COMMAND_TRACING in utils.h):
+//  - main() marks four points of every command: entry called, entry returned (action loop starts), action loop
+//      done (exit called), and exit returned. Along with the number of action iterations and whether the loop
+//      was cut short by sys_reset/sys_limit, these form one trace_record_t
+//  - The command type is the address of its entry function (look it up in the linker map). Types that share
+//      an entry function (e.g., the chess XY and Z moves) share an address
+//  - The last TRACE_RING_SIZE records are kept. Without COMMAND_TRACING, the TRACE_COMMAND_*() hooks compile away
+//  - The DEBUG_PORT 't' command dumps the ring in binary ('T' clears it):
+//      - Header (TRACE_HEADER_SIZE bytes): "TRC", TRACE_FORMAT_VERSION, record count (uint16_t),
+//          record size (uint16_t), records dropped while dumping (uint32_t), and the current time (uint32_t, us)
+//      - Then count trace_record_t's, oldest first, two per write. Everything is little-endian
+//  - Records are not kept while a dump is in progress (counted as dropped). The sequence number shows any gap
+//  - A turn starts at a gantry_human_entry record, so tools/trace_decode.py groups records into per-turn
+//      waterfalls (entry, action, and exit time of each command, from the four timestamps)
+
+#include "msp.h"
+#include "command_queue.h"
+#include "timebase.h"
+#include "utils.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General trace defines
+#define TRACE_RING_SIZE                     (128)       // Must be a power of two
+#define TRACE_RING_MASK                     (TRACE_RING_SIZE - 1)
+#define TRACE_FORMAT_VERSION                (1)
+#define TRACE_HEADER_SIZE                   (16)
+#define TRACE_RECORDS_PER_WRITE             (2)
+
+// Record flags
+#define TRACE_FLAG_RESET                    (0x01)      // sys_reset was set when the action loop ended
+#define TRACE_FLAG_LIMIT                    (0x02)      // sys_limit was set when the action loop ended
+
+// One command's lifecycle (timestamps are the low 32 bits of timebase_now_us())
+typedef struct trace_record_t {
+    uint32_t command;                               // Address of the entry function
+    uint32_t entry_us;                              // Entry called
+    uint32_t action_us;                             // Entry returned
+    uint32_t exit_us;                               // Exit called
+    uint32_t end_us;                                // Exit returned
+    uint32_t iterations;                            // Action calls
+    uint16_t sequence;                              // Counts every command, recorded or not
+    uint8_t flags;
+    uint8_t reserved;
+} trace_record_t;
+
+// Lifecycle hooks (for main())
+#ifdef COMMAND_TRACING
+#define TRACE_COMMAND_BEGIN(p_command)      trace_command_begin(p_command)
+#define TRACE_COMMAND_ACTION()              trace_command_action()
+#define TRACE_COMMAND_ITERATION()           trace_command_iteration()
+#define TRACE_COMMAND_EXIT()                trace_command_exit()
+#define TRACE_COMMAND_END()                 trace_command_end()
+#else
+#define TRACE_COMMAND_BEGIN(p_command)
+#define TRACE_COMMAND_ACTION()
+#define TRACE_COMMAND_ITERATION()
+#define TRACE_COMMAND_EXIT()
+#define TRACE_COMMAND_END()
+#endif
+
+// Public functions
+void trace_command_begin(command_t* p_command);
+void trace_command_action(void);
+void trace_command_iteration(void);
+void trace_command_exit(void);
+void trace_command_end(void);
+void trace_clear(void);
+void trace_dump_start(void);
+uint8_t trace_write_dump(uint16_t index, uint8_t* p_buffer, uint8_t size);
+
+#endif /* TRACE_H_ */
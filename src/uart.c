@@ -9,318 +9,178 @@
  * 
  */
 #include "uart.h"
+#include "isrprofile.h"
 
-// Declare the uart fifos
+// Declare the uart fifos and their storage
 fifo8_t fifo8s[NUMBER_OF_ACTIVE_UART_CHANNELS*2];
-static fifo8_t* uart_0_rx = &fifo8s[UART0_RX_ID];
-static fifo8_t* uart_0_tx = &fifo8s[UART0_TX_ID];
-static fifo8_t* uart_1_rx = &fifo8s[UART1_RX_ID];
-static fifo8_t* uart_1_tx = &fifo8s[UART1_TX_ID];
-static fifo8_t* uart_2_rx = &fifo8s[UART2_RX_ID];
-static fifo8_t* uart_2_tx = &fifo8s[UART2_TX_ID];
-static fifo8_t* uart_3_rx = &fifo8s[UART3_RX_ID];
-static fifo8_t* uart_3_tx = &fifo8s[UART3_TX_ID];
-static fifo8_t* uart_6_rx = &fifo8s[UART6_RX_ID];
-static fifo8_t* uart_6_tx = &fifo8s[UART6_TX_ID];
+static FIFO8_TYPE fifo8_buffers[NUMBER_OF_ACTIVE_UART_CHANNELS*2][UART_FIFO_SIZE];
+
+// Channel descriptors, indexed by UART_CHANNEL_X (unused channels have no module)
+static const uart_descriptor_t descriptors[NUMBER_OF_UART_CHANNELS] = {
+    [UART_CHANNEL_0] = {UART0, UART0_PORT, UART0_RX, UART0_TX, UART0_ALT_FUNCTION, UART0_INTERRUPT_NUM,
+                        UART0_BAUD_RATE, &fifo8s[UART0_RX_ID], &fifo8s[UART0_TX_ID],
+                        fifo8_buffers[UART0_RX_ID], fifo8_buffers[UART0_TX_ID]},
+    [UART_CHANNEL_1] = {UART1, UART1_PORT, UART1_RX, UART1_TX, UART1_ALT_FUNCTION, UART1_INTERRUPT_NUM,
+                        UART1_BAUD_RATE, &fifo8s[UART1_RX_ID], &fifo8s[UART1_TX_ID],
+                        fifo8_buffers[UART1_RX_ID], fifo8_buffers[UART1_TX_ID]},
+    [UART_CHANNEL_2] = {UART2, UART2_PORT, UART2_RX, UART2_TX, UART2_ALT_FUNCTION, UART2_INTERRUPT_NUM,
+                        UART2_BAUD_RATE, &fifo8s[UART2_RX_ID], &fifo8s[UART2_TX_ID],
+                        fifo8_buffers[UART2_RX_ID], fifo8_buffers[UART2_TX_ID]},
+    [UART_CHANNEL_3] = {UART3, UART3_PORT, UART3_RX, UART3_TX, UART3_ALT_FUNCTION, UART3_INTERRUPT_NUM,
+                        UART3_BAUD_RATE, &fifo8s[UART3_RX_ID], &fifo8s[UART3_TX_ID],
+                        fifo8_buffers[UART3_RX_ID], fifo8_buffers[UART3_TX_ID]},
+    [UART_CHANNEL_6] = {UART6, UART6_PORT, UART6_RX, UART6_TX, UART6_ALT_FUNCTION, UART6_INTERRUPT_NUM,
+                        UART6_BAUD_RATE, &fifo8s[UART6_RX_ID], &fifo8s[UART6_TX_ID],
+                        fifo8_buffers[UART6_RX_ID], fifo8_buffers[UART6_TX_ID]},
+};
+
+// Line state of each channel
+static uint32_t baud_rates[NUMBER_OF_UART_CHANNELS];
+static volatile uint32_t error_counts[NUMBER_OF_UART_CHANNELS];
+static uart_rx_handler_t rx_handlers[NUMBER_OF_UART_CHANNELS];
 
 // Private functions
-static void uart0_init(void);
-static void uart1_init(void);
-static void uart2_init(void);
-static void uart3_init(void);
-static void uart6_init(void);
-static void uart_copy_hardware_to_software(uint8_t uart_channel);
-static void uart_copy_software_to_hardware(uint8_t uart_channel);
+static const uart_descriptor_t* uart_get_descriptor(uint8_t uart_channel);
+static void uart_copy_hardware_to_software(uint8_t uart_channel, const uart_descriptor_t* p_descriptor);
+static void uart_copy_software_to_hardware(const uart_descriptor_t* p_descriptor);
+static void uart_kick_transmit(const uart_descriptor_t* p_descriptor);
 static void uart_interrupt_activity(uint8_t uart_channel);
 
 /**
- * @brief Configure UART on the specified channel
- * 
+ * @brief Helper function to look up a channel's descriptor
+ *
  * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @return The descriptor, or NULL if the channel is not in use
  */
-void uart_init(uint8_t uart_channel)
+static const uart_descriptor_t* uart_get_descriptor(uint8_t uart_channel)
 {
-    switch (uart_channel)
+    if ((uart_channel >= NUMBER_OF_UART_CHANNELS) || (descriptors[uart_channel].p_uart_module == NULL))
     {
-        case UART_CHANNEL_0:
-            uart0_init();
-        break;
-
-        case UART_CHANNEL_1:
-            uart1_init();
-        break;
-
-        case UART_CHANNEL_2:
-            uart2_init();
-        break;
-
-        case UART_CHANNEL_3:
-            uart3_init();
-        break;
-
-        case UART_CHANNEL_6:
-            uart6_init();
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-        break;
+        return NULL;
     }
-}
-
-/**
- * @brief Configure UART on channel 0
- */
-void uart0_init(void)
-{
-    // Initialize the software FIFOS
-    fifo8_init(uart_0_rx);
-    fifo8_init(uart_0_tx);
 
-    // Enable the UART clock gate control
-    utils_uart_clock_enable(UART_CHANNEL_0);
-
-    // Configure the transmit and receive GPIO
-    utils_gpio_clock_enable(UART0_PORT);
-    gpio_set_as_input(UART0_PORT, UART0_RX);
-    gpio_set_as_output(UART0_PORT, UART0_TX);
-    gpio_select_alternate_function(UART0_PORT, UART0_RX, 1);             // Select 1st alternate function for this GPIO pin
-    gpio_select_alternate_function(UART0_PORT, UART0_TX, 1);             // Select 1st alternate function for this GPIO pin
-
-    // Disable the UART module
-    UART0->CTL &= ~UART_CTL_UARTEN;
-
-    // Configure baude rate to be 9600 bits/sec
-    UART0->IBRD |= (UART0_DIVINT  << UART_IBRD_DIVINT_S);        // Sets DIVINT to 104
-    UART0->FBRD |= (UART0_DIVFRAC << UART_FBRD_DIVFRAC_S);       // Sets DIVFRAC to 11
-    UART0->LCRH |= (UART_LCRH_FEN);                              // Enables the hardware FIFOs
-    UART0->LCRH |= (UART_LCRH_WLEN_8);                           // Sets word length to 8 bits
-    UART0->CC   |= (UART_CC_CS_PIOSC);                           // Sets baud rate generator to PIOSC (16 MHz)
-
-    // Configure interrupts
-    UART0->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
-    UART0->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
-    utils_set_nvic(UART0_INTERRUPT_NUM, 0);                      // Configure the NVIC
-
-    // Enable the UART module
-    UART0->CTL  |= UART_CTL_UARTEN;
+    return &descriptors[uart_channel];
 }
 
 /**
- * @brief Configure UART on channel 1
+ * @brief Configure UART on the specified channel
+ * 
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
  */
-void uart1_init(void)
+void uart_init(uint8_t uart_channel)
 {
-    // Initialize the software FIFOS
-    fifo8_init(uart_1_rx);
-    fifo8_init(uart_1_tx);
-
-    // Enable the UART clock gate control
-    utils_uart_clock_enable(UART_CHANNEL_1);
-
-    // Configure the transmit and receive GPIO
-    utils_gpio_clock_enable(UART1_PORT);
-    gpio_set_as_input(UART1_PORT, UART1_RX);
-    gpio_set_as_output(UART1_PORT, UART1_TX);
-    gpio_select_alternate_function(UART1_PORT, UART1_RX, 1);             // Select 1st alternate function for this GPIO pin
-    gpio_select_alternate_function(UART1_PORT, UART1_TX, 1);             // Select 1st alternate function for this GPIO pin
-
-    // Disable the UART module
-    UART1->CTL &= ~UART_CTL_UARTEN;
-
-    // Configure baude rate to be 9600 bits/sec
-    UART1->IBRD |= (UART1_DIVINT  << UART_IBRD_DIVINT_S);        // Sets DIVINT to 104
-    UART1->FBRD |= (UART1_DIVFRAC << UART_FBRD_DIVFRAC_S);       // Sets DIVFRAC to 11
-    UART1->LCRH |= (UART_LCRH_FEN);                              // Enables the hardware FIFOs
-    UART1->LCRH |= (UART_LCRH_WLEN_8);                           // Sets word length to 8 bits
-    UART1->CC   |= (UART_CC_CS_PIOSC);                           // Sets baud rate generator to PIOSC (16 MHz)
-
-    // Configure interrupts
-    UART1->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
-    UART1->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
-    utils_set_nvic(UART1_INTERRUPT_NUM, 0);                      // Configure the NVIC
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
+    UART0_Type* p_uart_module;
 
-    // Enable the UART module
-    UART1->CTL  |= UART_CTL_UARTEN;
-}
+    // Invalid channel provided, do nothing
+    if (p_descriptor == NULL)
+    {
+        return;
+    }
+    p_uart_module = p_descriptor->p_uart_module;
 
-/**
- * @brief Configure UART on channel 2
- */
-void uart2_init(void)
-{
     // Initialize the software FIFOS
-    fifo8_init(uart_2_rx);
-    fifo8_init(uart_2_tx);
+    fifo8_init(p_descriptor->p_rx_fifo, p_descriptor->p_rx_buffer, UART_FIFO_SIZE);
+    fifo8_init(p_descriptor->p_tx_fifo, p_descriptor->p_tx_buffer, UART_FIFO_SIZE);
+    baud_rates[uart_channel] = p_descriptor->baud_rate;
 
     // Enable the UART clock gate control
-    utils_uart_clock_enable(UART_CHANNEL_2);
+    utils_uart_clock_enable(uart_channel);
 
     // Configure the transmit and receive GPIO
-    utils_gpio_clock_enable(UART2_PORT);
-    gpio_set_as_input(UART2_PORT, UART2_RX);
-    gpio_set_as_output(UART2_PORT, UART2_TX);
-    gpio_select_alternate_function(UART2_PORT, UART2_RX, 1);             // Select 1st alternate function for this GPIO pin
-    gpio_select_alternate_function(UART2_PORT, UART2_TX, 1);             // Select 1st alternate function for this GPIO pin
+    utils_gpio_clock_enable(p_descriptor->port);
+    gpio_set_as_input(p_descriptor->port, p_descriptor->rx_pin);
+    gpio_set_as_output(p_descriptor->port, p_descriptor->tx_pin);
+    gpio_select_alternate_function(p_descriptor->port, p_descriptor->rx_pin, p_descriptor->alternate_function);
+    gpio_select_alternate_function(p_descriptor->port, p_descriptor->tx_pin, p_descriptor->alternate_function);
 
     // Disable the UART module
-    UART2->CTL &= ~UART_CTL_UARTEN;
+    p_uart_module->CTL &= ~UART_CTL_UARTEN;
 
-    // Configure baude rate to be 9600 bits/sec
-    UART2->IBRD |= (UART2_DIVINT  << UART_IBRD_DIVINT_S);        // Sets DIVINT to 104
-    UART2->FBRD |= (UART2_DIVFRAC << UART_FBRD_DIVFRAC_S);       // Sets DIVFRAC to 11
-    UART2->LCRH |= (UART_LCRH_FEN);                              // Enables the hardware FIFOs
-    UART2->LCRH |= (UART_LCRH_WLEN_8);                           // Sets word length to 8 bits
-    UART2->CC   |= (UART_CC_CS_PIOSC);                           // Sets baud rate generator to PIOSC (16 MHz)
+    // Configure baude rate (9600 bits/sec until negotiated otherwise)
+    p_uart_module->IBRD = (UART_DIVINT(p_descriptor->baud_rate)  << UART_IBRD_DIVINT_S);     // Sets DIVINT
+    p_uart_module->FBRD = (UART_DIVFRAC(p_descriptor->baud_rate) << UART_FBRD_DIVFRAC_S);    // Sets DIVFRAC
+    p_uart_module->LCRH |= (UART_LCRH_FEN);                                                  // Enables the hardware FIFOs
+    p_uart_module->LCRH |= (UART_LCRH_WLEN_8);                                               // Sets word length to 8 bits
+    p_uart_module->CC   |= (UART_CC_CS_PIOSC);                                               // Sets baud rate generator to PIOSC (16 MHz)
 
     // Configure interrupts
-    UART2->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
-    UART2->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
-    utils_set_nvic(UART2_INTERRUPT_NUM, 0);                      // Configure the NVIC
+    p_uart_module->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
+    p_uart_module->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
+    utils_set_nvic(p_descriptor->interrupt_num, UART_INTERRUPT_PRIORITY); // Configure the NVIC
 
     // Enable the UART module
-    UART2->CTL  |= UART_CTL_UARTEN;
+    p_uart_module->CTL  |= UART_CTL_UARTEN;
 }
 
 /**
- * @brief Configure UART on channel 3
+ * @brief Sends a single byte (uint8_t) to the specified UART channel
+ * 
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @param byte The data to be sent
+ * @return Whether transmission was successful
  */
-void uart3_init(void)
+bool uart_out_byte(uint8_t uart_channel, uint8_t data)
 {
-    // Initialize the software FIFOS
-    fifo8_init(uart_3_rx);
-    fifo8_init(uart_3_tx);
-
-    // Enable the UART clock gate control
-    utils_uart_clock_enable(UART_CHANNEL_3);
-
-    // Configure the transmit and receive GPIO
-    utils_gpio_clock_enable(UART3_PORT);
-    gpio_set_as_input(UART3_PORT, UART3_RX);
-    gpio_set_as_output(UART3_PORT, UART3_TX);
-    gpio_select_alternate_function(UART3_PORT, UART3_RX, 1);             // Select 1st alternate function for this GPIO pin
-    gpio_select_alternate_function(UART3_PORT, UART3_TX, 1);             // Select 1st alternate function for this GPIO pin
+    bool status = true;
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
 
-    // Disable the UART module
-    UART3->CTL &= ~UART_CTL_UARTEN;
+    // If an invalid channel was provided, exit
+    if (p_descriptor == NULL)
+    {
+        return false;
+    }
 
-    // Configure baud rate to be 9600 bits/sec
-    UART3->IBRD |= (UART3_DIVINT  << UART_IBRD_DIVINT_S);        // Sets DIVINT to 104
-    UART3->FBRD |= (UART3_DIVFRAC << UART_FBRD_DIVFRAC_S);       // Sets DIVFRAC to 11
-    UART3->LCRH |= (UART_LCRH_FEN);                              // Enables the hardware FIFOs
-    UART3->LCRH |= (UART_LCRH_WLEN_8);                           // Sets word length to 8 bits
-    UART3->CC   |= (UART_CC_CS_PIOSC);                           // Sets baud rate generator to PIOSC (16 MHz)
+    // Load the value to the software FIFO
+    status = fifo8_push(p_descriptor->p_tx_fifo, data);
 
-    // Configure interrupts
-    UART3->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
-    UART3->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
-    utils_set_nvic(UART3_INTERRUPT_NUM, 0);                      // Configure the NVIC
+    // Start moving it to the hardware
+    uart_kick_transmit(p_descriptor);
 
-    // Enable the UART module
-    UART3->CTL  |= UART_CTL_UARTEN;
+    return status;
 }
 
 /**
- * @brief Configure UART on channel 6
+ * @brief Sends a block of bytes to the specified UART channel. Either all of them are queued or none are
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @param data The bytes to be sent (zeros included)
+ * @param size Number of bytes to send
+ * @return Whether the bytes were queued
  */
-void uart6_init(void)
+bool uart_out_bytes(uint8_t uart_channel, const uint8_t* data, uint16_t size)
 {
-    // Initialize the software FIFOS
-    fifo8_init(uart_6_rx);
-    fifo8_init(uart_6_tx);
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
 
-    // Enable the UART clock gate control
-    utils_uart_clock_enable(UART_CHANNEL_6);
-
-    // Configure the transmit and receive GPIO
-    utils_gpio_clock_enable(UART6_PORT);
-    gpio_set_as_input(UART6_PORT, UART6_RX);
-    gpio_set_as_output(UART6_PORT, UART6_TX);
-    gpio_select_alternate_function(UART6_PORT, UART6_RX, 1);             // Select 1st alternate function for this GPIO pin
-    gpio_select_alternate_function(UART6_PORT, UART6_TX, 1);             // Select 1st alternate function for this GPIO pin
-
-    // Disable the UART module
-    UART6->CTL &= ~UART_CTL_UARTEN;
-
-    // Configure baude rate to be 9600 bits/sec
-    UART6->IBRD |= (UART6_DIVINT  << UART_IBRD_DIVINT_S);        // Sets DIVINT to 104
-    UART6->FBRD |= (UART6_DIVFRAC << UART_FBRD_DIVFRAC_S);       // Sets DIVFRAC to 11
-    UART6->LCRH |= (UART_LCRH_FEN);                              // Enables the hardware FIFOs
-    UART6->LCRH |= (UART_LCRH_WLEN_8);                           // Sets word length to 8 bits
-    UART6->CC   |= (UART_CC_CS_PIOSC);                           // Sets baud rate generator to PIOSC (16 MHz)
+    // If an invalid channel was provided, or the block does not fit, exit
+    if ((p_descriptor == NULL) || (fifo8_get_free(p_descriptor->p_tx_fifo) < size))
+    {
+        return false;
+    }
 
-    // Configure interrupts
-    UART6->IFLS |= (UART_IFLS_RX1_8 | UART_IFLS_TX1_8);          // Sets Tx/Rx interrupt triggers to when FIFOs are 1/8 full
-    UART6->IM   |= (UART_IM_RXIM | UART_IM_TXIM | UART_IM_RTIM); // Enable the Tx and Rx FIFOs, and Rx timeout interrupt
-    utils_set_nvic(UART6_INTERRUPT_NUM, 0);                      // Configure the NVIC
+    // Load the whole block to the software FIFO, then start moving it to the hardware
+    fifo8_push_n(p_descriptor->p_tx_fifo, data, size);
+    uart_kick_transmit(p_descriptor);
 
-    // Enable the UART module
-    UART6->CTL  |= UART_CTL_UARTEN;
+    return true;
 }
 
 /**
- * @brief Sends a single byte (uint8_t) to the specified UART channel
- * 
- * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
- * @param byte The data to be sent
- * @return Whether transmission was successful
+ * @brief Helper function to copy queued bytes to the hardware if its Tx FIFO has room. The Tx interrupt only
+ *  fires when the hardware FIFO drains past its trigger level, so bytes are kicked here until it is full
+ *  and the interrupt takes over
+ *
+ * @param p_descriptor The channel's descriptor
  */
-bool uart_out_byte(uint8_t uart_channel, uint8_t data)
+static void uart_kick_transmit(const uart_descriptor_t* p_descriptor)
 {
-    bool status = true;
-    fifo8_t* p_uart_tx_fifo;
-    UART0_Type* p_uart_module;
-
-    // Get pointers for the appropriate UART module
-    switch (uart_channel)
-    {
-        case UART_CHANNEL_0:
-            p_uart_tx_fifo = uart_0_tx;
-            p_uart_module = UART0;
-        break;
-
-        case UART_CHANNEL_1:
-            p_uart_tx_fifo = uart_1_tx;
-            p_uart_module = UART1;
-        break;
-
-        case UART_CHANNEL_2:
-            p_uart_tx_fifo = uart_2_tx;
-            p_uart_module = UART2;
-        break;
-
-        case UART_CHANNEL_3:
-            p_uart_tx_fifo = uart_3_tx;
-            p_uart_module = UART3;
-        break;
-
-        case UART_CHANNEL_6:
-            p_uart_tx_fifo = uart_6_tx;
-            p_uart_module = UART6;
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-            status = false;
-        break;
-    }
-
-    // If an invalid channel was provided, exit
-    if (!status)
-    {
-        return false;
-    }
-
-    // Load the value to the software FIFO
-    status = fifo8_push(p_uart_tx_fifo, data);
-
-    // If the Tx FIFO is empty copy to hardware
-    if (p_uart_module->FR & UART_FR_TXFE)
+    if ((p_descriptor->p_uart_module->FR & UART_FR_TXFF) == 0)
     {
-        uart_copy_software_to_hardware(uart_channel);
+        // Mask the Tx interrupt so only one context pops the software FIFO at a time
+        p_descriptor->p_uart_module->IM &= ~UART_IM_TXIM;
+        uart_copy_software_to_hardware(p_descriptor);
+        p_descriptor->p_uart_module->IM |= UART_IM_TXIM;
     }
-
-    return status;
 }
 
 /**
@@ -333,17 +193,14 @@ bool uart_out_byte(uint8_t uart_channel, uint8_t data)
  */
 bool uart_out_string(uint8_t uart_channel, char* data, uint8_t size)
 {
-    bool status = true;
-
-    // Write one byte at a time
-    int i = 0;
-    for (i = 0; (i < size) && (status) && (data[i] != '\0'); i++)
+    // Stop at a null-terminator, then send the string as one block
+    uint8_t length = 0;
+    while ((length < size) && (data[length] != '\0'))
     {
-        status &= uart_out_byte(uart_channel, (uint8_t) data[i]);
+        length++;
     }
 
-
-    return status;
+    return uart_out_bytes(uart_channel, (uint8_t*) data, length);
 }
 
 /**
@@ -407,6 +264,13 @@ bool uart_out_uint32_t(uint8_t uart_channel, uint32_t data)
 bool uart_read_byte(uint8_t uart_channel, uint8_t* byte)
 {
     bool status = false;
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
+
+    // Invalid channel provided, do nothing
+    if (p_descriptor == NULL)
+    {
+        return false;
+    }
 
     // Read the appropriate channel
     while (!status)
@@ -418,36 +282,9 @@ bool uart_read_byte(uint8_t uart_channel, uint8_t* byte)
         }
         
         // Try to read a byte
-        switch (uart_channel)
-        {
-            case UART_CHANNEL_0:
-                status = fifo8_pop(uart_0_rx, byte);
-            break;
-
-            case UART_CHANNEL_1:
-                status = fifo8_pop(uart_1_rx, byte);
-            break;
-
-            case UART_CHANNEL_2:
-                status = fifo8_pop(uart_2_rx, byte);
-            break;
-
-            case UART_CHANNEL_3:
-                status = fifo8_pop(uart_3_rx, byte);
-            break;
-
-            case UART_CHANNEL_6:
-                status = fifo8_pop(uart_6_rx, byte);
-            break;
-
-            default:
-                // Invalid channel provided, do nothing
-                status = false;
-            break;
-        }
+        status = fifo8_pop(p_descriptor->p_rx_fifo, byte);
     }
 
-
     return status;
 }
 
@@ -462,44 +299,16 @@ bool uart_read_byte(uint8_t uart_channel, uint8_t* byte)
 bool uart_read_byte_unblocked(uint8_t uart_channel, uint8_t* byte)
 {
     bool status = false;
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
 
-    // Read the appropriate channel
-
-    // Short circuit if a fault occurs
-    if (sys_fault)
+    // Short circuit if a fault occurs or an invalid channel was provided
+    if ((sys_fault) || (p_descriptor == NULL))
     {
         return false;
     }
 
     // Try to read a byte
-    switch (uart_channel)
-    {
-        case UART_CHANNEL_0:
-            status = fifo8_pop(uart_0_rx, byte);
-        break;
-
-        case UART_CHANNEL_1:
-            status = fifo8_pop(uart_1_rx, byte);
-        break;
-
-        case UART_CHANNEL_2:
-            status = fifo8_pop(uart_2_rx, byte);
-        break;
-
-        case UART_CHANNEL_3:
-            status = fifo8_pop(uart_3_rx, byte);
-        break;
-
-        case UART_CHANNEL_6:
-            status = fifo8_pop(uart_6_rx, byte);
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-            status = false;
-        break;
-    }
-
+    status = fifo8_pop(p_descriptor->p_rx_fifo, byte);
 
     return status;
 }
@@ -552,230 +361,232 @@ bool uart_read_string_unblocked(uint8_t uart_channel, char *data, uint8_t size)
  * @brief Moves data from the hardware FIFO to our software one
  *
  * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @param p_descriptor The channel's descriptor
  */
-static void uart_copy_hardware_to_software(uint8_t uart_channel)
+static void uart_copy_hardware_to_software(uint8_t uart_channel, const uart_descriptor_t* p_descriptor)
 {
-    bool status = true;
     uint8_t byte;
-    fifo8_t* p_uart_rx_fifo;
-    UART0_Type* p_uart_module;
+    UART0_Type* p_uart_module = p_descriptor->p_uart_module;
+    fifo8_t* p_uart_rx_fifo = p_descriptor->p_rx_fifo;
 
-    // Get pointers for the appropriate UART module
-    switch (uart_channel)
+    // While the Rx hardware FIFO is not empty and the software FIFO is not full (or bytes go to a handler), copy data over
+    uart_rx_handler_t p_handler = rx_handlers[uart_channel];
+    while (((p_uart_module->FR & UART_FR_RXFE) == 0) && ((p_handler != NULL) || !fifo8_is_full(p_uart_rx_fifo)))
     {
-        case UART_CHANNEL_0:
-            p_uart_rx_fifo = uart_0_rx;
-            p_uart_module = UART0;
-        break;
-
-        case UART_CHANNEL_1:
-            p_uart_rx_fifo = uart_1_rx;
-            p_uart_module = UART1;
-        break;
-
-        case UART_CHANNEL_2:
-            p_uart_rx_fifo = uart_2_rx;
-            p_uart_module = UART2;
-        break;
-
-        case UART_CHANNEL_3:
-            p_uart_rx_fifo = uart_3_rx;
-            p_uart_module = UART3;
-        break;
-
-        case UART_CHANNEL_6:
-            p_uart_rx_fifo = uart_6_rx;
-            p_uart_module = UART6;
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-            status = false;
-        break;
+        uint32_t data = p_uart_module->DR;
+
+        // Count framing/parity/break/overrun errors (a sign of a mismatched baud rate)
+        if (data & UART_DR_ERROR_MASK)
+        {
+            error_counts[uart_channel]++;
+        }
+
+        byte = (data & UART_DR_DATA_M);
+        if (p_handler != NULL)
+        {
+            p_handler(byte);
+        }
+        else
+        {
+            fifo8_push(p_uart_rx_fifo, byte);
+        }
     }
+}
 
-    // If an invalid channel was provided, exit
-    if (!status)
+/**
+ * @brief Moves data from our software FIFO to the hardware one
+ * 
+ * @param p_descriptor The channel's descriptor
+ */
+static void uart_copy_software_to_hardware(const uart_descriptor_t* p_descriptor)
+{
+    FIFO8_TYPE* p_bytes;
+    UART0_Type* p_uart_module = p_descriptor->p_uart_module;
+    fifo8_t* p_uart_tx_fifo = p_descriptor->p_tx_fifo;
+
+    // While the Tx hardware FIFO is not full and the software FIFO is not empty, copy data over straight
+    // from the software FIFO's storage (at most two spans, if the data wraps)
+    uint16_t span = fifo8_get_read_span(p_uart_tx_fifo, &p_bytes);
+    while ((span > 0) && ((p_uart_module->FR & UART_FR_TXFF) == 0))
     {
-        return;
+        uint16_t sent = 0;
+        while ((sent < span) && ((p_uart_module->FR & UART_FR_TXFF) == 0))
+        {
+            p_uart_module->DR = p_bytes[sent++];
+        }
+        fifo8_commit_read(p_uart_tx_fifo, sent);
+        span = fifo8_get_read_span(p_uart_tx_fifo, &p_bytes);
     }
+}
+
+/**
+ * @brief Clears the specified UART fifos
+ * 
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ */
+void uart_reset(uint8_t uart_channel)
+{
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
+    uint32_t primask = 0;
 
-    // While the Rx hardware FIFO is not empty and the software FIFO is not full, copy data over
-    while (((p_uart_module->FR & UART_FR_RXFE) == 0) && (fifo8_get_size(p_uart_rx_fifo) < FIFO8_SIZE))
+    // Invalid channel provided, do nothing
+    if (p_descriptor == NULL)
     {
-        byte = (p_uart_module->DR & UART_DR_DATA_M);
-        fifo8_push(p_uart_rx_fifo, byte);
+        return;
     }
+
+    // The Rx ISR pushes and the Tx ISR pops, so neither may run while the indices are moved
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    fifo8_clear(p_descriptor->p_rx_fifo);
+    fifo8_clear(p_descriptor->p_tx_fifo);
+
+    __set_PRIMASK(primask);
 }
 
 /**
- * @brief Moves data from our software FIFO to the hardware one
- * 
+ * @brief Changes the baud rate of a UART channel. Waits for any byte being shifted out to finish first
+ *
  * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @param baud_rate The new baud rate, between UART_MIN_BAUD_RATE and UART_MAX_BAUD_RATE
+ * @return Whether the rate was changed
  */
-static void uart_copy_software_to_hardware(uint8_t uart_channel)
+bool uart_set_baud_rate(uint8_t uart_channel, uint32_t baud_rate)
 {
-    bool status = true;
-    uint8_t byte;
-    fifo8_t* p_uart_tx_fifo;
     UART0_Type* p_uart_module;
 
-    // Get pointers for the appropriate UART module
-    switch (uart_channel)
+    // Check the rate can be generated from the PIOSC
+    if ((baud_rate < UART_MIN_BAUD_RATE) || (baud_rate > UART_MAX_BAUD_RATE))
     {
-        case UART_CHANNEL_0:
-            p_uart_tx_fifo = uart_0_tx;
-            p_uart_module = UART0;
-        break;
-
-        case UART_CHANNEL_1:
-            p_uart_tx_fifo = uart_1_tx;
-            p_uart_module = UART1;
-        break;
-
-        case UART_CHANNEL_2:
-            p_uart_tx_fifo = uart_2_tx;
-            p_uart_module = UART2;
-        break;
-
-        case UART_CHANNEL_3:
-            p_uart_tx_fifo = uart_3_tx;
-            p_uart_module = UART3;
-        break;
-
-        case UART_CHANNEL_6:
-            p_uart_tx_fifo = uart_6_tx;
-            p_uart_module = UART6;
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-            status = false;
-        break;
+        return false;
     }
 
-    // If an invalid channel was provided, exit
-    if (!status)
+    // Get a pointer to the appropriate UART module
+    const uart_descriptor_t* p_descriptor = uart_get_descriptor(uart_channel);
+    if (p_descriptor == NULL)
     {
-        return;
+        return false;
     }
+    p_uart_module = p_descriptor->p_uart_module;
 
-    // While the Rx hardware FIFO is not empty and the software FIFO is not full, copy data over
-    while (((p_uart_module->FR & UART_FR_TXFF) == 0) && !fifo8_is_empty(p_uart_tx_fifo))
+    // Let the transmitter drain so no byte straddles two rates
+    while (p_uart_module->FR & UART_FR_BUSY)
     {
-        if (fifo8_pop(p_uart_tx_fifo, &byte))
-        {
-            p_uart_module->DR = byte;
-        }
-        else
-        {
-            // For debugging purposes, something went wrong reading from the software FIFO
-        }
     }
+
+    // The divisors only latch on a write to LCRH, with the module disabled
+    uint32_t brd_x64 = UART_BRD_X64(baud_rate);
+    p_uart_module->CTL  &= ~UART_CTL_UARTEN;
+    p_uart_module->IBRD  = ((brd_x64 >> 6) << UART_IBRD_DIVINT_S);
+    p_uart_module->FBRD  = ((brd_x64 & 0x3F) << UART_FBRD_DIVFRAC_S);
+    p_uart_module->LCRH  = p_uart_module->LCRH;
+    p_uart_module->CTL  |= UART_CTL_UARTEN;
+
+    baud_rates[uart_channel] = baud_rate;
+    return true;
 }
 
 /**
- * @brief Clears the specified UART fifos
- * 
+ * @brief Gets the current baud rate of a UART channel
+ *
  * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @return The baud rate, or 0 if the channel has not been initialized
  */
-void uart_reset(uint8_t uart_channel)
+uint32_t uart_get_baud_rate(uint8_t uart_channel)
 {
-    switch (uart_channel)
+    if (uart_channel >= NUMBER_OF_UART_CHANNELS)
     {
-        case UART_CHANNEL_0:
-            fifo8_clear(uart_0_rx);
-            fifo8_clear(uart_0_tx);
-        break;
-
-        case UART_CHANNEL_1:
-            fifo8_clear(uart_1_rx);
-            fifo8_clear(uart_1_tx);
-        break;
-
-        case UART_CHANNEL_2:
-            fifo8_clear(uart_2_rx);
-            fifo8_clear(uart_2_tx);
-        break;
-
-        case UART_CHANNEL_3:
-            fifo8_clear(uart_3_rx);
-            fifo8_clear(uart_3_tx);
-        break;
-
-        case UART_CHANNEL_6:
-            fifo8_clear(uart_6_rx);
-            fifo8_clear(uart_6_tx);
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-        break;
+        return 0;
     }
+    return baud_rates[uart_channel];
 }
 
-/* Interrupts */
-
 /**
- * @brief Helper function to perform the interrupt activity for the specified UART channel and clear the intterrupt
+ * @brief Gets the number of bytes received with a framing, parity, break, or overrun error
  *
- * @param uart_channel One of UART_CHANNEL_X for X={0,...,7}
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @return The error count since boot
  */
-static void uart_interrupt_activity(uint8_t uart_channel)
+uint32_t uart_get_error_count(uint8_t uart_channel)
 {
-    bool status = true;
-    UART0_Type* p_uart_module;
+    if (uart_channel >= NUMBER_OF_UART_CHANNELS)
+    {
+        return 0;
+    }
+    return error_counts[uart_channel];
+}
 
-    // Get a pointer to the appropriate UART module
-    switch (uart_channel)
+/**
+ * @brief Counts a line error found by a driver that reads the data register itself (e.g., uartdma.c)
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ */
+void uart_count_error(uint8_t uart_channel)
+{
+    if (uart_channel < NUMBER_OF_UART_CHANNELS)
     {
-        case UART_CHANNEL_0:
-            p_uart_module = UART0;
-        break;
-
-        case UART_CHANNEL_1:
-            p_uart_module = UART1;
-        break;
-
-        case UART_CHANNEL_2:
-            p_uart_module = UART2;
-        break;
-
-        case UART_CHANNEL_3:
-            p_uart_module = UART3;
-        break;
-
-        case UART_CHANNEL_6:
-            p_uart_module = UART6;
-        break;
-
-        default:
-            // Invalid channel provided, do nothing
-            status = false;
-        break;
+        error_counts[uart_channel]++;
     }
+}
 
-    // If an invalid channel was provided, exit
-    if (!status)
+/**
+ * @brief Routes a channel's received bytes to a handler (e.g., a frame parser) instead of the software FIFO
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @param p_handler Called from the Rx ISR with each byte, or NULL to use the software FIFO again
+ */
+void uart_set_rx_handler(uint8_t uart_channel, uart_rx_handler_t p_handler)
+{
+    if (uart_channel >= NUMBER_OF_UART_CHANNELS)
     {
         return;
     }
+    rx_handlers[uart_channel] = p_handler;
+}
+
+/**
+ * @brief Gets the handler a channel's received bytes are routed to
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,1,2,3,6}
+ * @return The handler, or NULL if bytes go to the software FIFO
+ */
+uart_rx_handler_t uart_get_rx_handler(uint8_t uart_channel)
+{
+    if (uart_channel >= NUMBER_OF_UART_CHANNELS)
+    {
+        return NULL;
+    }
+    return rx_handlers[uart_channel];
+}
+
+/* Interrupts */
+
+/**
+ * @brief Helper function to perform the interrupt activity for the specified UART channel and clear the intterrupt
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,...,7}
+ */
+static void uart_interrupt_activity(uint8_t uart_channel)
+{
+    const uart_descriptor_t* p_descriptor = &descriptors[uart_channel];
+    UART0_Type* p_uart_module = p_descriptor->p_uart_module;
 
     // Check which interrupt occured
     if (p_uart_module->MIS & UART_MIS_TXMIS)        // Tx interrupt
     {
         p_uart_module->ICR |= UART_ICR_TXIC;        // Clear the interrupt
-        uart_copy_software_to_hardware(uart_channel);
+        uart_copy_software_to_hardware(p_descriptor);
     }
     else if (p_uart_module->MIS & UART_MIS_RXMIS)   // Rx interrupt
     {
         p_uart_module->ICR |= UART_ICR_RXIC;        // Clear the interrupt
-        uart_copy_hardware_to_software(uart_channel);
+        uart_copy_hardware_to_software(uart_channel, p_descriptor);
     }
     else if (p_uart_module->MIS & UART_MIS_RTMIS)   // Rx timeout interrupt
     {
         p_uart_module->ICR |= UART_ICR_RTIC;        // Clear the interrupt
-        uart_copy_hardware_to_software(uart_channel);
+        uart_copy_hardware_to_software(uart_channel, p_descriptor);
     }
     else {                                          // Some other interrupt, possibly a fault
         // For debugging purposes
@@ -788,8 +599,12 @@ static void uart_interrupt_activity(uint8_t uart_channel)
  */
 __interrupt void UART0_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_UART0);
+
     // Perform the UART interrupt activity (also clears interrupt)
     uart_interrupt_activity(UART_CHANNEL_0);
+
+    ISRPROFILE_EXIT(ISRPROFILE_UART0);
 }
 
 /**
@@ -797,8 +612,12 @@ __interrupt void UART0_HANDLER(void)
  */
 __interrupt void UART1_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_UART1);
+
     // Perform the UART interrupt activity (also clears interrupt)
     uart_interrupt_activity(UART_CHANNEL_1);
+
+    ISRPROFILE_EXIT(ISRPROFILE_UART1);
 }
 
 /**
@@ -806,8 +625,12 @@ __interrupt void UART1_HANDLER(void)
  */
 __interrupt void UART2_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_UART2);
+
     // Perform the UART interrupt activity (also clears interrupt)
     uart_interrupt_activity(UART_CHANNEL_2);
+
+    ISRPROFILE_EXIT(ISRPROFILE_UART2);
 }
 
 /**
@@ -815,8 +638,12 @@ __interrupt void UART2_HANDLER(void)
  */
 __interrupt void UART3_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_UART3);
+
     // Perform the UART interrupt activity (also clears interrupt)
     uart_interrupt_activity(UART_CHANNEL_3);
+
+    ISRPROFILE_EXIT(ISRPROFILE_UART3);
 }
 
 /**
@@ -824,8 +651,12 @@ __interrupt void UART3_HANDLER(void)
  */
 __interrupt void UART6_HANDLER(void)
 {
+    ISRPROFILE_ENTER(ISRPROFILE_UART6);
+
     // Perform the UART interrupt activity (also clears interrupt)
     uart_interrupt_activity(UART_CHANNEL_6);
+
+    ISRPROFILE_EXIT(ISRPROFILE_UART6);
 }
 
 /* End uart.c */
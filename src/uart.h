@@ -14,6 +14,9 @@
 // Note on UART:
 //  - Communication is done with receive (Rx) and transmit (Tx) hardware FIFOs
 //  - To read and write, date is moved to/from software FIFOs
+//  - Each channel in use has an entry in the const descriptor table in uart.c, and every function looks its
+//      channel up there. Adding a channel (e.g., UART4/5/7) takes its macros below, a table entry, a pair
+//      of FIFO IDs (NUMBER_OF_ACTIVE_UART_CHANNELS), and a UARTn_HANDLER
 //
 // Baude rate math:
 //  - Baude_Rate_Divisor = Baude_Rate_Generator / (Clock_Div * Baude_Rate)
@@ -21,9 +24,11 @@
 //  - All channels have the default Clock_Div of 16
 //  - Baude_Rate is set using DIVINT and DIVFRAC
 //  - DIVINT  = floor(Baude_Rate_Divisor)
-//  - DIVFRAC = ceil[(Baude_Rate_Divisor - DIVINT) * 64 + 0.5]
-//      - Ex: Baude_Rate=115200 <=> DIVINT=8  , DIVFRAC=52
+//  - DIVFRAC = round[(Baude_Rate_Divisor - DIVINT) * 64]
+//      - Ex: Baude_Rate=115200 <=> DIVINT=8  , DIVFRAC=44
 //      - Ex: Baude_Rate=9600   <=> DIVINT=104, DIVFRAC=11
+//  - UART_DIVINT()/UART_DIVFRAC() compute these from a channel's UARTn_BAUD_RATE at initialization,
+//      and uart_set_baud_rate() changes them at runtime
 
 #include "msp.h"
 #include <stdint.h>
@@ -41,6 +46,20 @@
 #define UART_CHANNEL_5                      (5)
 #define UART_CHANNEL_6                      (6)
 #define UART_CHANNEL_7                      (7)
+#define NUMBER_OF_UART_CHANNELS             (8)
+#define UART_FIFO_SIZE                      (FIFO8_SIZE)    // Software FIFO capacity, a power of two
+#define UART_INTERRUPT_PRIORITY             (1)         // Above the gantry and steppers, below the PC sampler
+
+// Baud rate macros
+#define UART_CLOCK_FREQUENCY                (16000000)  // PIOSC
+#define UART_DEFAULT_BAUD_RATE              (9600)
+#define UART_MIN_BAUD_RATE                  (245)       // DIVINT must fit in 16 bits
+#define UART_MAX_BAUD_RATE                  (1000000)   // Divisor must be at least 1
+#define UART_BRD_X64(baud)                  ((((4 * UART_CLOCK_FREQUENCY)) + ((baud) / 2)) / (baud))
+#define UART_DIVINT(baud)                   (UART_BRD_X64(baud) >> 6)
+#define UART_DIVFRAC(baud)                  (UART_BRD_X64(baud) & 0x3F)
+#define UART_DR_ERROR_MASK                  (UART_DR_OE | UART_DR_BE | UART_DR_PE | UART_DR_FE)
+#define UART_RSR_ERROR_MASK                 (UART_RSR_OE | UART_RSR_BE | UART_RSR_PE | UART_RSR_FE)
 
 // UART0 macros
 #define UART0_PORT                          (GPIOA)
@@ -48,8 +67,8 @@
 #define UART0_TX                            (GPIO_PIN_1)
 #define UART0_INTERRUPT_NUM                 (UART0_IRQn)
 #define UART0_HANDLER                       (UART0_IRQHandler)
-#define UART0_DIVINT                        (104)
-#define UART0_DIVFRAC                       (11)
+#define UART0_BAUD_RATE                     (UART_DEFAULT_BAUD_RATE)
+#define UART0_ALT_FUNCTION                  (1)
 #define UART0_RX_ID                         (0)
 #define UART0_TX_ID                         (1)
 
@@ -59,8 +78,8 @@
 #define UART1_TX                            (GPIO_PIN_1)
 #define UART1_INTERRUPT_NUM                 (UART1_IRQn)
 #define UART1_HANDLER                       (UART1_IRQHandler)
-#define UART1_DIVINT                        (104)
-#define UART1_DIVFRAC                       (11)
+#define UART1_BAUD_RATE                     (UART_DEFAULT_BAUD_RATE)
+#define UART1_ALT_FUNCTION                  (1)
 #define UART1_RX_ID                         (2)
 #define UART1_TX_ID                         (3)
 
@@ -70,8 +89,8 @@
 #define UART2_TX                            (GPIO_PIN_5)
 #define UART2_INTERRUPT_NUM                 (UART2_IRQn)
 #define UART2_HANDLER                       (UART2_IRQHandler)
-#define UART2_DIVINT                        (104)
-#define UART2_DIVFRAC                       (11)
+#define UART2_BAUD_RATE                     (UART_DEFAULT_BAUD_RATE)
+#define UART2_ALT_FUNCTION                  (1)
 #define UART2_RX_ID                         (4)
 #define UART2_TX_ID                         (5)
 
@@ -81,8 +100,8 @@
 #define UART3_TX                            (GPIO_PIN_5)
 #define UART3_INTERRUPT_NUM                 (UART3_IRQn)
 #define UART3_HANDLER                       (UART3_IRQHandler)
-#define UART3_DIVINT                        (104)
-#define UART3_DIVFRAC                       (11)
+#define UART3_BAUD_RATE                     (UART_DEFAULT_BAUD_RATE)
+#define UART3_ALT_FUNCTION                  (1)
 #define UART3_RX_ID                         (6)
 #define UART3_TX_ID                         (7)
 
@@ -92,14 +111,33 @@
 #define UART6_TX                            (GPIO_PIN_1)
 #define UART6_INTERRUPT_NUM                 (UART6_IRQn)
 #define UART6_HANDLER                       (UART6_IRQHandler)
-#define UART6_DIVINT                        (104)
-#define UART6_DIVFRAC                       (11)
+#define UART6_BAUD_RATE                     (UART_DEFAULT_BAUD_RATE)
+#define UART6_ALT_FUNCTION                  (1)
 #define UART6_RX_ID                         (8)
 #define UART6_TX_ID                         (9)
 
+// Channel descriptor (one per UART_CHANNEL_X, see uart.c)
+typedef struct uart_descriptor_t {
+    UART0_Type* p_uart_module;          // NULL if the channel is not in use
+    GPIO_Type* port;
+    uint8_t rx_pin;
+    uint8_t tx_pin;
+    uint8_t alternate_function;
+    uint8_t interrupt_num;
+    uint32_t baud_rate;                 // Rate at initialization
+    fifo8_t* p_rx_fifo;
+    fifo8_t* p_tx_fifo;
+    FIFO8_TYPE* p_rx_buffer;            // Storage for the FIFOs (UART_FIFO_SIZE each)
+    FIFO8_TYPE* p_tx_buffer;
+} uart_descriptor_t;
+
+// Receive handler, called from the Rx ISR with each byte instead of queuing it in the software FIFO
+typedef void (*uart_rx_handler_t)(uint8_t byte);
+
 // Public functions
 void uart_init(uint8_t uart_channel);
 bool uart_out_byte(uint8_t uart_channel, uint8_t byte);
+bool uart_out_bytes(uint8_t uart_channel, const uint8_t* data, uint16_t size);
 bool uart_read_byte(uint8_t uart_channel, uint8_t* byte);
 bool uart_read_byte_unblocked(uint8_t uart_channel, uint8_t* byte);
 bool uart_read_string(uint8_t uart_channel, char *data, uint8_t num_chars);
@@ -108,5 +146,11 @@ bool uart_out_string(uint8_t uart_channel, char* string, uint8_t size);
 bool uart_out_int16_t(uint8_t uart_channel, int16_t value);
 bool uart_out_uint32_t(uint8_t uart_channel, uint32_t value);
 void uart_reset(uint8_t uart_channel);
+bool uart_set_baud_rate(uint8_t uart_channel, uint32_t baud_rate);
+uint32_t uart_get_baud_rate(uint8_t uart_channel);
+uint32_t uart_get_error_count(uint8_t uart_channel);
+void uart_count_error(uint8_t uart_channel);
+void uart_set_rx_handler(uint8_t uart_channel, uart_rx_handler_t p_handler);
+uart_rx_handler_t uart_get_rx_handler(uint8_t uart_channel);
 
 #endif /* UART_H */
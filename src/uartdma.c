@@ -0,0 +1,366 @@
+/**
+ * @file uartdma.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Optional uDMA-backed transmit and receive for the UART channels
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "uartdma.h"
+
+// Hardware resources of a supported channel
+typedef struct uartdma_descriptor_t {
+    uint8_t uart_channel;
+    UART0_Type* p_uart_module;
+    uint8_t rx_udma_channel;
+    uint8_t tx_udma_channel;
+    uint8_t encoding;
+} uartdma_descriptor_t;
+
+// Buffers and positions of a supported channel
+typedef struct uartdma_state_t {
+    uint8_t rx_ring[UARTDMA_RX_RING_SIZE];
+    uint16_t read_index;                            // Next byte to hand to the Rx handler
+    uint16_t last_write_index;                      // Write position at the previous service
+    uint8_t tx_buffers[2][UARTDMA_TX_BUFFER_SIZE];
+    volatile uint8_t tx_lengths[2];
+    volatile uint8_t tx_active;                     // Buffer owned by the uDMA (the other one is filling)
+    volatile bool tx_busy;                          // Set while the caller fills/starts, so the service stays out
+    volatile uint32_t overruns;                     // Times the ring wrapped before it was serviced
+    volatile bool enabled;
+} uartdma_state_t;
+
+// Private functions
+static int8_t uartdma_find(uint8_t uart_channel);
+static uint32_t uartdma_rx_control(void);
+static void uartdma_arm_rx(uint8_t index);
+static uint16_t uartdma_get_write_index(uint8_t index);
+static void uartdma_service_rx(uint8_t index);
+static void uartdma_start_tx(uint8_t index);
+
+// Supported channels
+static const uartdma_descriptor_t descriptors[UARTDMA_NUMBER_OF_CHANNELS] = {
+    {UART_CHANNEL_0, UART0, UARTDMA_UART0_RX_CHANNEL, UARTDMA_UART0_TX_CHANNEL, UARTDMA_UART0_ENCODING},
+    {UART_CHANNEL_3, UART3, UARTDMA_UART3_RX_CHANNEL, UARTDMA_UART3_TX_CHANNEL, UARTDMA_UART3_ENCODING},
+};
+
+// Declare the channel states
+static uartdma_state_t states[UARTDMA_NUMBER_OF_CHANNELS];
+
+/**
+ * @brief Hands a UART channel over to the uDMA (call after uart_init())
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,3}
+ * @return Whether the channel is supported
+ */
+bool uartdma_init(uint8_t uart_channel)
+{
+    int8_t index = uartdma_find(uart_channel);
+    if (index < 0)
+    {
+        return false;
+    }
+
+    const uartdma_descriptor_t* p_descriptor = &descriptors[index];
+    uartdma_state_t* p_state = &states[index];
+
+    // Start with empty buffers
+    p_state->read_index       = 0;
+    p_state->last_write_index = 0;
+    p_state->tx_lengths[0]    = 0;
+    p_state->tx_lengths[1]    = 0;
+    p_state->tx_active        = 0;
+    p_state->tx_busy          = false;
+    p_state->overruns         = 0;
+
+    // Configure the uDMA channels
+    udma_init();
+    udma_assign_channel(p_descriptor->rx_udma_channel, p_descriptor->encoding);
+    udma_assign_channel(p_descriptor->tx_udma_channel, p_descriptor->encoding);
+    uartdma_arm_rx(index);
+
+    // The uDMA takes the received bytes, so the CPU no longer needs the Rx interrupts
+    p_descriptor->p_uart_module->IM     &= ~(UART_IM_RXIM | UART_IM_RTIM);
+    p_descriptor->p_uart_module->DMACTL |= (UART_DMACTL_RXDMAE | UART_DMACTL_TXDMAE);
+
+    p_state->enabled = true;
+    return true;
+}
+
+/**
+ * @brief Helper function to find the descriptor of a UART channel
+ *
+ * @param uart_channel The UART channel
+ * @return The index into the descriptor table, or -1 if the channel is not supported
+ */
+static int8_t uartdma_find(uint8_t uart_channel)
+{
+    int8_t i = 0;
+    for (i = 0; i < UARTDMA_NUMBER_OF_CHANNELS; i++)
+    {
+        if (descriptors[i].uart_channel == uart_channel)
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Helper function to get the control word of one Rx half
+ *
+ * @return The DMACHCTL word
+ */
+static uint32_t uartdma_rx_control(void)
+{
+    return (UDMA_CHCTL_DSTINC_8 | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_NONE | UDMA_CHCTL_SRCSIZE_8 |
+            UDMA_CHCTL_ARBSIZE_1 | ((UARTDMA_RX_HALF_SIZE - 1) << UDMA_CHCTL_XFERSIZE_S) | UDMA_CHCTL_XFERMODE_PINGPONG);
+}
+
+/**
+ * @brief Helper function to point both Rx halves at the ring and enable the Rx channel
+ *
+ * @param index Index of the channel
+ */
+static void uartdma_arm_rx(uint8_t index)
+{
+    const uartdma_descriptor_t* p_descriptor = &descriptors[index];
+    udma_control_t* p_primary   = udma_get_primary(p_descriptor->rx_udma_channel);
+    udma_control_t* p_alternate = udma_get_alternate(p_descriptor->rx_udma_channel);
+
+    // The primary structure fills the first half, the alternate the second
+    p_primary->p_src_end   = &p_descriptor->p_uart_module->DR;
+    p_primary->p_dst_end   = &states[index].rx_ring[UARTDMA_RX_HALF_SIZE - 1];
+    p_primary->control     = uartdma_rx_control();
+    p_alternate->p_src_end = &p_descriptor->p_uart_module->DR;
+    p_alternate->p_dst_end = &states[index].rx_ring[UARTDMA_RX_RING_SIZE - 1];
+    p_alternate->control   = uartdma_rx_control();
+
+    UDMA->ALTCLR = (1 << p_descriptor->rx_udma_channel);
+    udma_enable_channel(p_descriptor->rx_udma_channel);
+}
+
+/**
+ * @brief Helper function to get the ring index the uDMA will write next
+ *
+ * @param index Index of the channel
+ * @return The write index
+ */
+static uint16_t uartdma_get_write_index(uint8_t index)
+{
+    uint8_t rx_udma_channel = descriptors[index].rx_udma_channel;
+    udma_control_t* p_active = udma_get_primary(rx_udma_channel);
+    uint16_t base = 0;
+    uint16_t remaining = 0;
+
+    // ALTSET tells which half the uDMA is filling
+    if (UDMA->ALTSET & (1 << rx_udma_channel))
+    {
+        p_active = udma_get_alternate(rx_udma_channel);
+        base     = UARTDMA_RX_HALF_SIZE;
+    }
+
+    // A stopped structure has no transfers remaining, otherwise XFERSIZE holds (remaining - 1)
+    if ((p_active->control & UDMA_CHCTL_XFERMODE_M) != UDMA_CHCTL_XFERMODE_STOP)
+    {
+        remaining = ((p_active->control & UDMA_CHCTL_XFERSIZE_M) >> UDMA_CHCTL_XFERSIZE_S) + 1;
+    }
+
+    return (base + UARTDMA_RX_HALF_SIZE - remaining) % UARTDMA_RX_RING_SIZE;
+}
+
+/**
+ * @brief Helper function to re-arm finished Rx halves and pass new bytes to the Rx handler
+ *
+ * @param index Index of the channel
+ */
+static void uartdma_service_rx(uint8_t index)
+{
+    const uartdma_descriptor_t* p_descriptor = &descriptors[index];
+    uartdma_state_t* p_state = &states[index];
+    udma_control_t* p_primary   = udma_get_primary(p_descriptor->rx_udma_channel);
+    udma_control_t* p_alternate = udma_get_alternate(p_descriptor->rx_udma_channel);
+
+    // If both halves filled between services the channel stopped itself, so start over
+    if (!udma_is_channel_enabled(p_descriptor->rx_udma_channel))
+    {
+        p_state->overruns++;
+        p_state->read_index       = 0;
+        p_state->last_write_index = 0;
+        uartdma_arm_rx(index);
+        return;
+    }
+
+    // Re-arm whichever half the uDMA finished (it is filling the other one)
+    if ((p_primary->control & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP)
+    {
+        p_primary->control = uartdma_rx_control();
+    }
+    if ((p_alternate->control & UDMA_CHCTL_XFERMODE_M) == UDMA_CHCTL_XFERMODE_STOP)
+    {
+        p_alternate->control = uartdma_rx_control();
+    }
+
+    // The uDMA only moves the data bits, so count line errors from the sticky status (any write clears it)
+    if (p_descriptor->p_uart_module->RSR & UART_RSR_ERROR_MASK)
+    {
+        uart_count_error(p_descriptor->uart_channel);
+        p_descriptor->p_uart_module->RSR = 0;
+    }
+
+    // Hand over the waiting bytes once the line goes idle, or half the ring is waiting
+    uint16_t write_index = uartdma_get_write_index(index);
+    uint16_t waiting = (write_index + UARTDMA_RX_RING_SIZE - p_state->read_index) % UARTDMA_RX_RING_SIZE;
+    bool idle = (write_index == p_state->last_write_index);
+    p_state->last_write_index = write_index;
+
+    if ((waiting == 0) || ((!idle) && (waiting < UARTDMA_RX_HALF_SIZE)))
+    {
+        return;
+    }
+
+    uart_rx_handler_t p_handler = uart_get_rx_handler(p_descriptor->uart_channel);
+    while (p_state->read_index != write_index)
+    {
+        if (p_handler != NULL)
+        {
+            p_handler(p_state->rx_ring[p_state->read_index]);
+        }
+        p_state->read_index = (p_state->read_index + 1) % UARTDMA_RX_RING_SIZE;
+    }
+}
+
+/**
+ * @brief Helper function to send the filling Tx buffer, if it has data and the uDMA is free
+ *
+ * @param index Index of the channel
+ */
+static void uartdma_start_tx(uint8_t index)
+{
+    const uartdma_descriptor_t* p_descriptor = &descriptors[index];
+    uartdma_state_t* p_state = &states[index];
+    uint8_t filling = p_state->tx_active ^ 1;
+    uint8_t length  = p_state->tx_lengths[filling];
+
+    if ((length == 0) || udma_is_channel_enabled(p_descriptor->tx_udma_channel))
+    {
+        return;
+    }
+
+    // The sent buffer becomes the filling one
+    p_state->tx_lengths[p_state->tx_active] = 0;
+    p_state->tx_active = filling;
+
+    // A basic transfer stops the channel once the last byte is in the Tx FIFO
+    udma_control_t* p_primary = udma_get_primary(p_descriptor->tx_udma_channel);
+    p_primary->p_src_end = &p_state->tx_buffers[filling][length - 1];
+    p_primary->p_dst_end = &p_descriptor->p_uart_module->DR;
+    p_primary->control   = (UDMA_CHCTL_DSTINC_NONE | UDMA_CHCTL_DSTSIZE_8 | UDMA_CHCTL_SRCINC_8 |
+                            UDMA_CHCTL_SRCSIZE_8 | UDMA_CHCTL_ARBSIZE_4 |
+                            ((length - 1) << UDMA_CHCTL_XFERSIZE_S) | UDMA_CHCTL_XFERMODE_BASIC);
+    udma_enable_channel(p_descriptor->tx_udma_channel);
+}
+
+/**
+ * @brief Queues data to be sent by the uDMA. Never waits
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,3}
+ * @param data Bytes to send
+ * @param size Number of bytes to send
+ * @return Whether the data was queued (false if the channel is not enabled or the Tx buffer is full)
+ */
+bool uartdma_transmit(uint8_t uart_channel, const char* data, uint8_t size)
+{
+    int8_t index = uartdma_find(uart_channel);
+    if ((index < 0) || (!states[index].enabled))
+    {
+        return false;
+    }
+
+    uartdma_state_t* p_state = &states[index];
+    bool status = false;
+
+    // Keep the service routine from swapping buffers while this one fills
+    p_state->tx_busy = true;
+
+    uint8_t filling = p_state->tx_active ^ 1;
+    uint8_t length  = p_state->tx_lengths[filling];
+    if ((length + size) <= UARTDMA_TX_BUFFER_SIZE)
+    {
+        uint8_t i = 0;
+        for (i = 0; i < size; i++)
+        {
+            p_state->tx_buffers[filling][length + i] = (uint8_t) data[i];
+        }
+        p_state->tx_lengths[filling] = length + size;
+        status = true;
+    }
+
+    // Send right away if the uDMA is free
+    uartdma_start_tx(index);
+    p_state->tx_busy = false;
+
+    return status;
+}
+
+/**
+ * @brief Discards received bytes that have not been handed to the Rx handler yet
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,3}
+ */
+void uartdma_reset(uint8_t uart_channel)
+{
+    int8_t index = uartdma_find(uart_channel);
+    if ((index < 0) || (!states[index].enabled))
+    {
+        return;
+    }
+
+    states[index].read_index       = uartdma_get_write_index(index);
+    states[index].last_write_index = states[index].read_index;
+}
+
+/**
+ * @brief Services every enabled channel. Call once per gantry timer period
+ */
+void uartdma_service(void)
+{
+    uint8_t i = 0;
+    for (i = 0; i < UARTDMA_NUMBER_OF_CHANNELS; i++)
+    {
+        if (!states[i].enabled)
+        {
+            continue;
+        }
+
+        uartdma_service_rx(i);
+
+        // Start the next Tx buffer, unless the caller is filling it
+        if (!states[i].tx_busy)
+        {
+            uartdma_start_tx(i);
+        }
+    }
+}
+
+/**
+ * @brief Gets the number of times the Rx ring overflowed
+ *
+ * @param uart_channel One of UART_CHANNEL_X for X={0,3}
+ * @return The overrun count
+ */
+uint32_t uartdma_get_overruns(uint8_t uart_channel)
+{
+    int8_t index = uartdma_find(uart_channel);
+    if (index < 0)
+    {
+        return 0;
+    }
+
+    return states[index].overruns;
+}
+
+/* End uartdma.c */
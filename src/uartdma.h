@@ -0,0 +1,55 @@
+/**
+ * @file uartdma.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Optional uDMA-backed transmit and receive for the UART channels
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef UARTDMA_H_
+#define UARTDMA_H_
+
+// Note on the uDMA UART driver (enabled with UART_DMA in utils.h):
+//  - Call uartdma_init() after uart_init(). From then on the uDMA, not the Rx/Tx interrupts, moves the data
+//  - Rx: a ping-pong transfer fills the two halves of a ring buffer, one byte per UART request
+//      - The write position comes from the remaining transfer count of the active control structure
+//      - uartdma_service() (from the gantry timer ISR) re-arms a finished half and hands new bytes to the
+//          channel's Rx handler (uart_set_rx_handler()). Channels without a handler discard their bytes
+//      - Bytes are handed over once the line has been idle for a service period, or half the ring is waiting,
+//          so the handler sees whole frames in one burst rather than one interrupt per byte
+//  - Tx: frames are copied into the filling half of a double buffer, and a basic transfer sends the other
+//      half. uartdma_transmit() never waits; the next buffer starts from the caller or the service routine
+//  - DR is read one byte wide, so the error bits of each byte are lost. uartdma_service() instead checks the
+//      sticky receive status register (RSR) every service period, counting a line error (uart_count_error())
+//      for each period in which one was latched, then clears it
+
+#include "msp.h"
+#include "uart.h"
+#include "udma.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General uDMA UART defines
+#define UARTDMA_RX_RING_SIZE                (64)
+#define UARTDMA_RX_HALF_SIZE                (UARTDMA_RX_RING_SIZE / 2)    // At most 1024 (one transfer)
+#define UARTDMA_TX_BUFFER_SIZE              (32)
+#define UARTDMA_NUMBER_OF_CHANNELS          (2)
+
+// uDMA channel assignments of the supported UART channels
+#define UARTDMA_UART0_RX_CHANNEL            (8)
+#define UARTDMA_UART0_TX_CHANNEL            (9)
+#define UARTDMA_UART0_ENCODING              (0)
+#define UARTDMA_UART3_RX_CHANNEL            (16)
+#define UARTDMA_UART3_TX_CHANNEL            (17)
+#define UARTDMA_UART3_ENCODING              (2)
+
+// Public functions
+bool uartdma_init(uint8_t uart_channel);
+bool uartdma_transmit(uint8_t uart_channel, const char* data, uint8_t size);
+void uartdma_reset(uint8_t uart_channel);
+void uartdma_service(void);
+uint32_t uartdma_get_overruns(uint8_t uart_channel);
+
+#endif /* UARTDMA_H_ */
@@ -0,0 +1,117 @@
+/**
+ * @file udma.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Provides the shared uDMA control table and channel helpers
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#include "udma.h"
+
+// Declare the control table (primary structures, then alternate structures)
+static udma_control_t control_table[2 * UDMA_NUMBER_OF_CHANNELS] __attribute__((aligned(UDMA_CONTROL_TABLE_ALIGNMENT)));
+
+// Private variables
+static bool udma_initialized = false;
+
+/**
+ * @brief Initialize the uDMA controller. Safe to call from every module that uses it
+ */
+void udma_init(void)
+{
+    if (udma_initialized)
+    {
+        return;
+    }
+
+    // Enable the uDMA clock and wait for it to be ready
+    SYSCTL->RCGCDMA |= SYSCTL_RCGCDMA_R0;
+    while (!(SYSCTL->PRDMA & SYSCTL_PRDMA_R0))
+    {
+    }
+
+    // Enable the controller and point it at the control table
+    UDMA->CFG     = UDMA_CFG_MASTEN;
+    UDMA->CTLBASE = (uint32_t) control_table;
+
+    udma_initialized = true;
+}
+
+/**
+ * @brief Maps a channel to a peripheral and resets the channel's attributes
+ *
+ * @param channel One of {0,...,31}
+ * @param encoding The channel encoding of the desired peripheral
+ */
+void udma_assign_channel(uint8_t channel, uint8_t encoding)
+{
+    uint32_t channel_mask = (1 << channel);
+
+    // The CHMAPn registers are consecutive, each holding 8 channels
+    volatile uint32_t* p_chmap = (&UDMA->CHMAP0) + (channel / UDMA_CHANNELS_PER_MAP);
+    uint32_t shift = (channel % UDMA_CHANNELS_PER_MAP) * UDMA_CHANNEL_MAP_BITS;
+    *p_chmap = ((*p_chmap) & ~(0xF << shift)) | (((uint32_t) encoding) << shift);
+
+    // Default attributes: primary structure, single and burst requests, default priority
+    UDMA->ALTCLR      = channel_mask;
+    UDMA->USEBURSTCLR = channel_mask;
+    UDMA->REQMASKCLR  = channel_mask;
+    UDMA->PRIOCLR     = channel_mask;
+}
+
+/**
+ * @brief Gets a channel's primary control structure
+ *
+ * @param channel One of {0,...,31}
+ * @return Pointer to the control structure
+ */
+udma_control_t* udma_get_primary(uint8_t channel)
+{
+    return &control_table[channel];
+}
+
+/**
+ * @brief Gets a channel's alternate control structure
+ *
+ * @param channel One of {0,...,31}
+ * @return Pointer to the control structure
+ */
+udma_control_t* udma_get_alternate(uint8_t channel)
+{
+    return &control_table[UDMA_NUMBER_OF_CHANNELS + channel];
+}
+
+/**
+ * @brief Enables a channel so it responds to requests
+ *
+ * @param channel One of {0,...,31}
+ */
+void udma_enable_channel(uint8_t channel)
+{
+    UDMA->ENASET = (1 << channel);
+}
+
+/**
+ * @brief Disables a channel
+ *
+ * @param channel One of {0,...,31}
+ */
+void udma_disable_channel(uint8_t channel)
+{
+    UDMA->ENACLR = (1 << channel);
+}
+
+/**
+ * @brief Checks if a channel is enabled. The hardware disables a channel when its transfer completes
+ *
+ * @param channel One of {0,...,31}
+ * @return true if the channel is still enabled
+ */
+bool udma_is_channel_enabled(uint8_t channel)
+{
+    return ((UDMA->ENASET & (1 << channel)) != 0);
+}
+
+/* End udma.c */
@@ -0,0 +1,47 @@
+/**
+ * @file udma.h
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Provides the shared uDMA control table and channel helpers
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+#ifndef UDMA_H_
+#define UDMA_H_
+
+// Note on the uDMA:
+//  - The control table holds a primary and an alternate control structure for each of the 32 channels
+//  - Every module using the uDMA shares the one table, so call udma_init() before configuring any channel
+//  - Channel/encoding pairs come from the "uDMA Channel Assignments" table of the datasheet
+//  - End pointers point at the LAST item of a transfer, not one past it
+
+#include "msp.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// General uDMA defines
+#define UDMA_NUMBER_OF_CHANNELS             (32)
+#define UDMA_CHANNELS_PER_MAP               (8)         // Channels per CHMAPn register
+#define UDMA_CHANNEL_MAP_BITS               (4)         // Bits per channel in a CHMAPn register
+#define UDMA_CONTROL_TABLE_ALIGNMENT        (1024)
+
+// Control structure (one per channel per primary/alternate)
+typedef struct udma_control_t {
+    volatile void* p_src_end;           // Address of the last source item
+    volatile void* p_dst_end;           // Address of the last destination item
+    uint32_t control;                   // DMACHCTL word
+    uint32_t spare;                     // Unused by the hardware
+} udma_control_t;
+
+// Public functions
+void udma_init(void);
+void udma_assign_channel(uint8_t channel, uint8_t encoding);
+udma_control_t* udma_get_primary(uint8_t channel);
+udma_control_t* udma_get_alternate(uint8_t channel);
+void udma_enable_channel(uint8_t channel);
+void udma_disable_channel(uint8_t channel);
+bool udma_is_channel_enabled(uint8_t channel);
+
+#endif /* UDMA_H_ */
@@ -9,6 +9,7 @@
  */
 
 #include "utils.h"
+#include "clock.h"
 
 /* GPIO, Interrupt, and Empty */
 
@@ -197,14 +198,58 @@ void utils_timer_clock_enable(TIMER0_Type* timer)
 }
 
 /**
- * @brief Delay the next operation with a for-loop (used to space-out UART communication during testing)
+ * @brief Enables the DWT cycle counter, which counts core clock cycles (wraps every ~35s at 120MHz)
+ */
+void utils_cycle_counter_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;         // Enable the trace/debug blocks
+    DWT->CYCCNT       = 0;                                  // Reset the counter
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;             // Start counting
+}
+
+/**
+ * @brief Gets the current value of the DWT cycle counter
  *
- * @param ticks Number of clock ticks to delay
+ * @return The number of core clock cycles since the counter was started (modulo 2^32)
  */
-void utils_delay(uint32_t ticks)
+uint32_t utils_get_cycles(void)
 {
-    int i;
-    for (i = 0; i < ticks; i++) {}
+    return DWT->CYCCNT;
+}
+
+/**
+ * @brief Busy-waits for a number of core clock cycles. The time does not depend on compiler settings
+ *
+ * @param cycles Number of core clock cycles to wait
+ */
+void utils_delay_cycles(uint32_t cycles)
+{
+    uint32_t start = DWT->CYCCNT;
+
+    // Unsigned subtraction handles the counter wrapping
+    while ((DWT->CYCCNT - start) < cycles)
+    {
+    }
+}
+
+/**
+ * @brief Busy-waits for at least a number of nanoseconds (resolution is one core clock cycle)
+ *
+ * @param ns Number of nanoseconds to wait, at most ~35s
+ */
+void utils_delay_ns(uint32_t ns)
+{
+    utils_delay_cycles((uint32_t) CLOCK_NS_TO_CYCLES((uint64_t) ns));
+}
+
+/**
+ * @brief Busy-waits for at least a number of microseconds
+ *
+ * @param us Number of microseconds to wait, at most ~35s
+ */
+void utils_delay_us(uint32_t us)
+{
+    utils_delay_cycles(CLOCK_US_TO_CYCLES(us));
 }
 
 /**
@@ -13,8 +13,17 @@
 
 // Debug mode select
 #define PERIPHERALS_ENABLED         // Enable electromagent and sensor network
+//#define SENSOR_DMA_SCAN             // Scan the sensor network with the uDMA instead of the CPU
+//#define UART_DMA                    // Move Raspberry Pi UART data with the uDMA instead of the CPU
+//#define COBS_FRAMING                // Byte-stuff Raspberry Pi frames with COBS (the Pi must match)
+//#define SLIDING_WINDOW_LINK         // Use the version 2 (sliding window) Raspberry Pi link (the Pi must match)
 //#define GANTRY_DEBUG                // Run specific gantry commands
 //#define STEPPER_DEBUG               // Debug motion profiling
+//#define REPLAY_MODE                 // Replay a recorded game with the robot and time it (see replay.h)
+//#define DEBUG_PORT                  // Answer single-key debug commands on UART0 (see debug.h)
+//#define ISR_PROFILING               // Time every interrupt handler (report with the DEBUG_PORT 'i' command)
+//#define COMMAND_TRACING             // Record every command's lifecycle (dump with the DEBUG_PORT 't' command)
+//#define PC_SAMPLING                 // Sample the program counter every ~1ms (dump with the DEBUG_PORT 'p' command)
 
 // Game mode select (define at most one at a time)
 //#define THREE_PARTY_MODE            // User sends moves to MSP, which sends moves to RPi, which sends moves back
@@ -30,6 +39,7 @@
 
 #include "msp.h"
 #include "command_queue.h"
+#include "memstats.h"
 #include "uart.h"
 #include <stdint.h>
 #include <stdbool.h>
@@ -38,6 +48,7 @@
 // General utility macros
 #define BITS8_MASK(shift)                   ((uint8_t) (1 << shift))
 #define BITS16_MASK(shift)                  ((uint16_t) (0x0001 << shift))
+#define BITS32_MASK(shift)                  ((uint32_t) (1UL << (shift)))
 #define BITS64_MASK(shift)                  ((uint64_t) (1ULL << shift))
 
 // Chess-specific macros
@@ -173,7 +184,11 @@ typedef enum peripheral_state_t {
 void utils_gpio_clock_enable(GPIO_Type* port);
 void utils_uart_clock_enable(uint8_t uart_channel);
 void utils_timer_clock_enable(TIMER0_Type* timer);
-void utils_delay(uint32_t ticks);
+void utils_cycle_counter_init(void);
+uint32_t utils_get_cycles(void);
+void utils_delay_cycles(uint32_t cycles);
+void utils_delay_ns(uint32_t ns);
+void utils_delay_us(uint32_t us);
 void utils_set_nvic(uint8_t interrupt_num, uint8_t priority);
 void utils_empty_function(command_t* command);
 
@@ -0,0 +1,321 @@
+/**
+ * @file frame_bench.c
+ * @author Nick Cooney (npc4crc@virginia.edu)
+ * @brief Host harness for the frame parser: round trips, random corruption, and decode throughput
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2026
+ */
+
+// Note on building and running (from the repository root, on the host):
+//  - cc -std=c99 -O2 -Isrc -o frame_bench tools/frame_bench.c src/frame.c
+//  - ./frame_bench [frames] [seed]
+//  - frame.c only depends on frame.h, so the parser under test is the one the MSP runs
+//  - The exit status is nonzero if any check fails
+
+// Note on the checks:
+//  - Clean: every frame (raw and COBS) decodes to what was sent, operands full of START/ACK/0x00 bytes included
+//  - Corruption (COBS): one frame in four gets a random byte overwritten, dropped, or inserted. The first frame
+//      that starts after a delimiter must always decode, i.e., the parser is back in step within one frame. That
+//      is the next frame, unless the corruption hit the delimiter itself and merged the two (then the one after)
+//  - A corrupted frame is never posted with the wrong contents unless its check bytes happen to match (counted,
+//      not failed)
+//  - Throughput: decode rate of back-to-back COBS frames with the longest operand field, in MB/s
+
+#include "frame.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Harness defines
+#define BENCH_DEFAULT_FRAMES                (100000)
+#define BENCH_THROUGHPUT_FRAMES             (1000000)
+#define BENCH_CORRUPT_ONE_IN                (4)
+#define BENCH_MAX_RAW_LENGTH                (4 + FRAME_MAX_OPERANDS)
+#define BENCH_MAX_ENCODED_LENGTH            (FRAME_COBS_MAX_LENGTH(BENCH_MAX_RAW_LENGTH) + 1)  // + an inserted byte
+#define BENCH_INSTRUCTION                   (0x03)
+
+// Private functions
+static void bench_check_bytes(const uint8_t* p_data, uint8_t count, uint8_t check_bytes[2]);
+static uint8_t bench_build_frame(uint8_t length, uint8_t* p_frame);
+static uint16_t bench_corrupt(uint8_t* p_encoded, uint16_t length);
+static bool bench_matches(const frame_t* p_frame, const uint8_t* p_raw);
+static uint32_t bench_clean(uint32_t frames, bool cobs);
+static uint32_t bench_corruption(uint32_t frames);
+static void bench_throughput(void);
+
+/**
+ * @brief Fletcher-16 check bytes of a buffer (same math as utils_fl16_data_to_checkbytes())
+ *
+ * @param p_data The bytes to check
+ * @param count The number of bytes
+ * @param check_bytes The check bytes
+ */
+static void bench_check_bytes(const uint8_t* p_data, uint8_t count, uint8_t check_bytes[2])
+{
+    uint16_t sum1 = 0;
+    uint16_t sum2 = 0;
+    uint16_t c0 = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        sum1 = (sum1 + p_data[i]) % 0xFF;
+        sum2 = (sum2 + sum1) % 0xFF;
+    }
+
+    c0 = (0xFF - ((sum1 + sum2) % 0xFF));
+    check_bytes[0] = c0;
+    check_bytes[1] = (0xFF - ((sum1 + c0) % 0xFF));
+}
+
+/**
+ * @brief Builds a version 1 frame with random operands, biased towards the bytes the parser treats specially
+ *
+ * @param length The number of operand bytes
+ * @param p_frame The frame (at least BENCH_MAX_RAW_LENGTH bytes)
+ * @return The length of the frame
+ */
+static uint8_t bench_build_frame(uint8_t length, uint8_t* p_frame)
+{
+    static const uint8_t special[] = {FRAME_COBS_DELIMITER, START_BYTE, START_BYTE_V2, ACK_BYTE};
+    uint8_t i = 0;
+
+    p_frame[0] = START_BYTE;
+    p_frame[1] = (BENCH_INSTRUCTION << 4) | length;
+    for (i = 0; i < length; i++)
+    {
+        p_frame[2 + i] = (rand() % 2) ? special[rand() % sizeof(special)] : (uint8_t) rand();
+    }
+    bench_check_bytes(p_frame, 2 + length, &p_frame[2 + length]);
+
+    return (4 + length);
+}
+
+/**
+ * @brief Overwrites, drops, or inserts one byte of an encoded frame
+ *
+ * @param p_encoded The encoded frame (with room for one more byte)
+ * @param length Its length
+ * @return The new length
+ */
+static uint16_t bench_corrupt(uint8_t* p_encoded, uint16_t length)
+{
+    uint16_t at = rand() % length;
+
+    switch (rand() % 3)
+    {
+        case 0:
+            p_encoded[at] ^= (1 + (rand() % 0xFF));
+        break;
+
+        case 1:
+            memmove(&p_encoded[at], &p_encoded[at + 1], length - at - 1);
+            length--;
+        break;
+
+        default:
+            memmove(&p_encoded[at + 1], &p_encoded[at], length - at);
+            p_encoded[at] = (uint8_t) rand();
+            length++;
+        break;
+    }
+
+    return length;
+}
+
+/**
+ * @brief Whether a decoded frame carries the contents of a raw one
+ *
+ * @param p_frame The decoded frame
+ * @param p_raw The raw frame that was sent
+ * @return true if they match
+ */
+static bool bench_matches(const frame_t* p_frame, const uint8_t* p_raw)
+{
+    return ((p_frame->version == 1) &&
+            (p_frame->instruction == FRAME_INSTR(p_raw[1])) &&
+            (p_frame->length == FRAME_LENGTH(p_raw[1])) &&
+            (memcmp(p_frame->operands, &p_raw[2], p_frame->length) == 0));
+}
+
+/**
+ * @brief Sends clean frames through the parser and checks every one decodes
+ *
+ * @param frames The number of frames
+ * @param cobs Whether to COBS-encode them
+ * @return The number of failures
+ */
+static uint32_t bench_clean(uint32_t frames, bool cobs)
+{
+    frame_parser_t parser;
+    frame_t frame;
+    uint8_t raw[BENCH_MAX_RAW_LENGTH];
+    uint8_t encoded[BENCH_MAX_ENCODED_LENGTH];
+    uint8_t* p_bytes = raw;
+    uint16_t length = 0;
+    uint16_t i = 0;
+    uint32_t n = 0;
+    uint32_t failures = 0;
+
+    frame_parser_init(&parser);
+
+    for (n = 0; n < frames; n++)
+    {
+        length = bench_build_frame(rand() % (FRAME_MAX_OPERANDS + 1), raw);
+        if (cobs)
+        {
+            length  = frame_cobs_encode(raw, length, encoded);
+            p_bytes = encoded;
+        }
+
+        for (i = 0; i < length; i++)
+        {
+            if (cobs)
+            {
+                frame_parser_feed_cobs(&parser, p_bytes[i]);
+            }
+            else
+            {
+                frame_parser_feed(&parser, p_bytes[i]);
+            }
+        }
+
+        if ((!frame_parser_pop(&parser, &frame)) || (!bench_matches(&frame, raw)))
+        {
+            failures++;
+        }
+    }
+
+    printf("clean (%s): %u/%u frames decoded\n", cobs ? "COBS" : "raw", (unsigned) (frames - failures), (unsigned) frames);
+    return failures;
+}
+
+/**
+ * @brief Sends COBS frames with random corruption, and checks the parser is back in step within one frame
+ *
+ * @param frames The number of frames
+ * @return The number of failures
+ */
+static uint32_t bench_corruption(uint32_t frames)
+{
+    frame_parser_t parser;
+    frame_t frame;
+    uint8_t raw[BENCH_MAX_RAW_LENGTH];
+    uint8_t encoded[BENCH_MAX_ENCODED_LENGTH];
+    uint16_t length = 0;
+    uint16_t i = 0;
+    uint32_t n = 0;
+    uint32_t corrupted = 0;
+    uint32_t followers = 0;
+    uint32_t resynced = 0;
+    uint32_t false_accepts = 0;
+    uint8_t frames_to_resync = 0;
+    bool corrupt = false;
+    bool decoded = false;
+
+    frame_parser_init(&parser);
+
+    for (n = 0; n < frames; n++)
+    {
+        length  = bench_build_frame(rand() % (FRAME_MAX_OPERANDS + 1), raw);
+        length  = frame_cobs_encode(raw, length, encoded);
+        corrupt = ((rand() % BENCH_CORRUPT_ONE_IN) == 0);
+        if (corrupt)
+        {
+            length = bench_corrupt(encoded, length);
+            corrupted++;
+
+            // Without its delimiter, this frame runs into the next one, so the one after is the first in step
+            frames_to_resync = (encoded[length - 1] == FRAME_COBS_DELIMITER) ? 1 : 2;
+        }
+
+        for (i = 0; i < length; i++)
+        {
+            frame_parser_feed_cobs(&parser, encoded[i]);
+        }
+
+        // A corrupted frame may still post something (a dropped delimiter merges it with the next one)
+        decoded = false;
+        while (frame_parser_pop(&parser, &frame))
+        {
+            if (bench_matches(&frame, raw))
+            {
+                decoded = true;
+            }
+            else
+            {
+                false_accepts++;
+            }
+        }
+
+        // The first clean frame after the parser must be back in step
+        if ((!corrupt) && (frames_to_resync > 0) && (--frames_to_resync == 0))
+        {
+            followers++;
+            resynced += decoded;
+        }
+    }
+
+    printf("corruption: %u corrupted, %u/%u first frames in step decoded, %u resyncs, %u check errors, %u false accepts\n",
+           (unsigned) corrupted, (unsigned) resynced, (unsigned) followers, (unsigned) parser.resyncs,
+           (unsigned) parser.check_errors, (unsigned) false_accepts);
+    return (followers - resynced);
+}
+
+/**
+ * @brief Measures the COBS decode rate for frames with the longest operand field
+ */
+static void bench_throughput(void)
+{
+    frame_parser_t parser;
+    frame_t frame;
+    uint8_t raw[BENCH_MAX_RAW_LENGTH];
+    uint8_t encoded[BENCH_MAX_ENCODED_LENGTH];
+    uint16_t length = 0;
+    uint16_t i = 0;
+    uint32_t n = 0;
+    uint32_t decoded = 0;
+    double seconds = 0;
+    clock_t start;
+
+    frame_parser_init(&parser);
+    length = bench_build_frame(FRAME_MAX_OPERANDS, raw);
+    length = frame_cobs_encode(raw, length, encoded);
+
+    start = clock();
+    for (n = 0; n < BENCH_THROUGHPUT_FRAMES; n++)
+    {
+        for (i = 0; i < length; i++)
+        {
+            frame_parser_feed_cobs(&parser, encoded[i]);
+        }
+        decoded += frame_parser_pop(&parser, &frame);
+    }
+    seconds = ((double) (clock() - start)) / CLOCKS_PER_SEC;
+
+    printf("throughput: %u frames of %u bytes in %.3f s, %.1f MB/s, %.0f ns/byte (%u decoded)\n",
+           (unsigned) BENCH_THROUGHPUT_FRAMES, (unsigned) length, seconds,
+           ((double) BENCH_THROUGHPUT_FRAMES * length) / seconds / 1e6,
+           seconds * 1e9 / ((double) BENCH_THROUGHPUT_FRAMES * length), (unsigned) decoded);
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t frames = (argc > 1) ? (uint32_t) strtoul(argv[1], NULL, 0) : BENCH_DEFAULT_FRAMES;
+    uint32_t failures = 0;
+
+    srand((argc > 2) ? (unsigned) strtoul(argv[2], NULL, 0) : 1);
+
+    failures += bench_clean(frames, false);
+    failures += bench_clean(frames, true);
+    failures += bench_corruption(frames);
+    bench_throughput();
+
+    printf("%s\n", (failures == 0) ? "PASS" : "FAIL");
+    return (failures == 0) ? 0 : 1;
+}
+
+/* End frame_bench.c */
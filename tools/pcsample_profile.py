@@ -0,0 +1,156 @@
+#!/usr/bin/env python3
+"""
+@file pcsample_profile.py
+@author Nick Cooney (npc4crc@virginia.edu)
+@brief Turns PC sample dumps (DEBUG_PORT 'p') into a flat profile of the firmware
+@version 0.1
+@date 2026-10-18
+
+@copyright Copyright (c) 2026
+
+Note on the input (see pcsample.h):
+ - A capture of the bytes DEBUG_CHANNEL sent after one or more 'p' commands. Each dump is found by its "PCS"
+     magic and format version, and anything between dumps is skipped
+ - Header (16 bytes): "PCS", format version, sample count (uint16), reserved (uint16), samples dropped so far
+     (uint32), and the sample period (uint32, cycles)
+ - Then count PCs (uint32 each), oldest first. Everything is little-endian
+
+Note on the output:
+ - Each PC is mapped to the function containing it with the firmware's symbol table (nm -n -S). The flat
+     profile lists every function with its samples, share, running share, and estimated time
+ - With --lines N, the N hottest PCs are also mapped to source lines with addr2line
+ - PCs in no known function (e.g., ROM driverlib calls) are grouped as "?"
+
+Usage:
+    python3 tools/pcsample_profile.py capture.bin --elf firmware.out [--lines 20]
+"""
+
+import argparse
+import bisect
+import collections
+import struct
+import subprocess
+import sys
+
+# Dump format defines (pcsample.h)
+PCSAMPLE_FORMAT_VERSION = 1
+PCSAMPLE_MAGIC          = b"PCS" + bytes([PCSAMPLE_FORMAT_VERSION])   # Magic and version, to skip stray "PCS" text
+PCSAMPLE_HEADER         = struct.Struct("<3sBHHII")
+PCSAMPLE_PC             = struct.Struct("<I")
+SYSCLOCK_FREQUENCY      = 120000000
+UNKNOWN_FUNCTION        = "?"
+
+
+def parse_dumps(data):
+    """Returns every PC in a capture, the latest dropped count, and the sample period (cycles)"""
+    pcs = []
+    dumps = 0
+    dropped = 0
+    period = 0
+    start = data.find(PCSAMPLE_MAGIC)
+
+    while start >= 0:
+        if start + PCSAMPLE_HEADER.size > len(data):
+            print("warning: capture ends inside a header", file=sys.stderr)
+            break
+
+        magic, version, count, _, dropped, period = PCSAMPLE_HEADER.unpack_from(data, start)
+        offset = start + PCSAMPLE_HEADER.size
+        available = (len(data) - offset) // PCSAMPLE_PC.size
+        if available < count:
+            print("warning: capture ends after %d of %d samples" % (available, count), file=sys.stderr)
+            count = available
+        pcs.extend(pc for (pc,) in PCSAMPLE_PC.iter_unpack(data[offset:offset + (count * PCSAMPLE_PC.size)]))
+        dumps += 1
+
+        start = data.find(PCSAMPLE_MAGIC, offset + (count * PCSAMPLE_PC.size))
+
+    if dumps == 0:
+        raise ValueError("no complete \"PCS\" header (format version %d) in the capture" % PCSAMPLE_FORMAT_VERSION)
+
+    return pcs, dumps, dropped, period
+
+
+def load_functions(elf, nm):
+    """Returns (sorted start addresses, ends, names) of the function symbols in elf, from nm"""
+    output = subprocess.run([nm, "-n", "-S", elf], check=True, capture_output=True, text=True).stdout
+    starts = []
+    ends = []
+    names = []
+    for line in output.splitlines():
+        fields = line.split()
+        # Symbols with a size have four fields (address, size, type, name)
+        if (len(fields) == 4) and (fields[2] in "tTwW"):
+            start = int(fields[0], 16) & ~1
+            starts.append(start)
+            ends.append(start + int(fields[1], 16))
+            names.append(fields[3])
+    return starts, ends, names
+
+
+def function_of(functions, pc):
+    """Names the function containing pc (Thumb bit ignored)"""
+    starts, ends, names = functions
+    pc &= ~1
+    i = bisect.bisect_right(starts, pc) - 1
+
+    # Aliases share a start address, so check each of them
+    j = i
+    while (j >= 0) and (starts[j] == starts[i]):
+        if pc < ends[j]:
+            return names[j]
+        j -= 1
+    return UNKNOWN_FUNCTION
+
+
+def source_lines(elf, addr2line, pcs):
+    """Maps PCs to "function at file:line" with addr2line"""
+    output = subprocess.run([addr2line, "-f", "-C", "-e", elf] + ["0x%x" % (pc & ~1) for pc in pcs],
+                            check=True, capture_output=True, text=True).stdout.splitlines()
+    return ["%s at %s" % (output[2 * i], output[(2 * i) + 1]) for i in range(len(pcs))]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flat profile from PC sample dumps (DEBUG_PORT 'p')")
+    parser.add_argument("capture", help="binary capture of the dump(s) ('-' for stdin)")
+    parser.add_argument("--elf", required=True, help="firmware image the samples were taken from")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm to read the image with (default: %(default)s)")
+    parser.add_argument("--addr2line", default="arm-none-eabi-addr2line",
+                        help="addr2line for --lines (default: %(default)s)")
+    parser.add_argument("--lines", type=int, default=0, help="also show the N hottest PCs as source lines")
+    parser.add_argument("--clock", type=int, default=SYSCLOCK_FREQUENCY,
+                        help="CPU clock in Hz, to turn the period into time (default: %(default)s)")
+    args = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if args.capture == "-" else open(args.capture, "rb").read()
+    pcs, dumps, dropped, period = parse_dumps(data)
+    if not pcs:
+        print("no samples in %d dump(s)" % dumps)
+        return 0
+
+    functions = load_functions(args.elf, args.nm)
+    counts = collections.Counter(function_of(functions, pc) for pc in pcs)
+    total = len(pcs)
+    sample_ms = (1000.0 * period / args.clock) if period else 0.0
+
+    print("%d samples from %d dump(s), %d dropped, one per %d cycles (%.3f ms)" % (total, dumps, dropped, period, sample_ms))
+    print()
+    print("%8s %7s %7s %10s  %s" % ("samples", "%", "cum %", "est. ms", "function"))
+    cumulative = 0
+    for name, count in counts.most_common():
+        cumulative += count
+        print("%8d %6.2f%% %6.2f%% %10.1f  %s" % (count, 100.0 * count / total, 100.0 * cumulative / total,
+                                                  count * sample_ms, name))
+
+    if args.lines > 0:
+        hottest = collections.Counter(pc & ~1 for pc in pcs).most_common(args.lines)
+        print()
+        print("%8s %7s  %-10s  %s" % ("samples", "%", "pc", "source"))
+        for (pc, count), line in zip(hottest, source_lines(args.elf, args.addr2line, [pc for pc, _ in hottest])):
+            print("%8d %6.2f%%  0x%08x  %s" % (count, 100.0 * count / total, pc, line))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,192 @@
+#!/usr/bin/env python3
+"""
+@file trace_decode.py
+@author Nick Cooney (npc4crc@virginia.edu)
+@brief Decodes a command trace dump (DEBUG_PORT 't') and prints a per-turn timing waterfall
+@version 0.1
+@date 2026-10-18
+
+@copyright Copyright (c) 2026
+
+Note on the input (see trace.h):
+ - A capture of the bytes DEBUG_CHANNEL sent after 't'. Anything before the "TRC" magic and format version
+     is skipped
+ - Header (16 bytes): "TRC", format version, record count (uint16), record size (uint16), records dropped
+     while dumping (uint32), and the current time (uint32, us)
+ - Then count records of record size bytes, oldest first: command (entry function address), entry_us,
+     action_us, exit_us, end_us, iterations (uint32 each), sequence (uint16), flags, reserved (uint8 each)
+ - Everything is little-endian. Timestamps are the low 32 bits of timebase_now_us(), so differences wrap
+
+Note on the output:
+ - With --elf, command addresses are named from the firmware's symbol table (nm). Otherwise they are shown
+     in hex, and --turn-start gives the address of gantry_human_entry
+ - A turn starts at each gantry_human_entry record. Each command gets a line with its start time within the
+     turn, its entry/action/exit times, and a bar ('e' entry, '=' action, 'x' exit) on a common time scale
+ - Gaps in the sequence numbers (commands not recorded) are shown between the lines
+
+Usage:
+    python3 tools/trace_decode.py capture.bin [--elf firmware.out] [--width 60]
+"""
+
+import argparse
+import bisect
+import struct
+import subprocess
+import sys
+
+# Dump format defines (trace.h)
+TRACE_FORMAT_VERSION = 1
+TRACE_MAGIC          = b"TRC" + bytes([TRACE_FORMAT_VERSION])   # Magic and version, to skip stray "TRC" text
+TRACE_HEADER         = struct.Struct("<3sBHHII")
+TRACE_RECORD         = struct.Struct("<6IHBB")
+TRACE_FLAG_RESET     = 0x01
+TRACE_FLAG_LIMIT     = 0x02
+TURN_START_SYMBOL    = "gantry_human_entry"
+WRAP_32              = 0xFFFFFFFF
+
+
+def load_symbols(elf, nm):
+    """Returns (sorted addresses, names) of the function symbols in elf, from nm (Thumb bit cleared)"""
+    output = subprocess.run([nm, "-n", elf], check=True, capture_output=True, text=True).stdout
+    addresses = []
+    names = []
+    for line in output.splitlines():
+        fields = line.split()
+        if (len(fields) == 3) and (fields[1] in "tTwW"):
+            addresses.append(int(fields[0], 16) & ~1)  # Thumb functions have bit 0 set
+            names.append(fields[2])
+    return addresses, names
+
+
+def symbol_name(symbols, address):
+    """Names a code address (Thumb bit ignored), or shows it in hex"""
+    address &= ~1
+    if symbols:
+        addresses, names = symbols
+        i = bisect.bisect_right(addresses, address) - 1
+        if (i >= 0) and (addresses[i] == address):
+            return names[i]
+    return "0x%08x" % address
+
+
+def parse_dump(data):
+    """Returns the header fields and the list of records in a dump capture"""
+    start = data.find(TRACE_MAGIC)
+    if start < 0:
+        raise ValueError("no \"TRC\" header (format version %d) in the capture" % TRACE_FORMAT_VERSION)
+    if start + TRACE_HEADER.size > len(data):
+        raise ValueError("capture ends inside the header")
+
+    magic, version, count, record_size, dropped, now_us = TRACE_HEADER.unpack_from(data, start)
+    if record_size < TRACE_RECORD.size:
+        raise ValueError("record size %d is shorter than a trace_record_t" % record_size)
+
+    records = []
+    offset = start + TRACE_HEADER.size
+    for i in range(count):
+        if offset + record_size > len(data):
+            print("warning: capture ends after %d of %d records" % (i, count), file=sys.stderr)
+            break
+        command, entry, action, exit_, end, iterations, sequence, flags, _ = TRACE_RECORD.unpack_from(data, offset)
+        records.append({
+            "command": command,
+            "entry": entry,
+            "action": action,
+            "exit": exit_,
+            "end": end,
+            "iterations": iterations,
+            "sequence": sequence,
+            "flags": flags,
+        })
+        offset += record_size
+
+    return {"count": count, "record_size": record_size, "dropped": dropped, "now_us": now_us}, records
+
+
+def split_turns(records, turn_start):
+    """Groups records into turns, each starting at a turn_start record (anything before is turn 0)"""
+    turns = [[]]
+    for record in records:
+        if ((record["command"] & ~1) == turn_start) and turns[-1]:
+            turns.append([])
+        turns[-1].append(record)
+    return [turn for turn in turns if turn]
+
+
+def elapsed(later, earlier):
+    """Difference of two wrapping 32-bit microsecond timestamps"""
+    return (later - earlier) & WRAP_32
+
+
+def print_turn(number, turn, symbols, width):
+    """Prints one turn's waterfall"""
+    origin = turn[0]["entry"]
+    span = max(elapsed(record["end"], origin) for record in turn) or 1
+    scale = width / span
+
+    print("Turn %d: %d commands, %.1f ms" % (number, len(turn), span / 1000.0))
+    print("  %-28s %10s %9s %9s %9s %7s  %s" % ("command", "start ms", "entry ms", "action ms", "exit ms", "iters", "waterfall"))
+
+    previous = None
+    for record in turn:
+        if (previous is not None) and (((record["sequence"] - previous) & 0xFFFF) > 1):
+            print("  ... %d commands not recorded" % (((record["sequence"] - previous) & 0xFFFF) - 1))
+        previous = record["sequence"]
+
+        start  = elapsed(record["entry"], origin)
+        entry  = elapsed(record["action"], record["entry"])
+        action = elapsed(record["exit"], record["action"])
+        exit_  = elapsed(record["end"], record["exit"])
+
+        # One character at least for each phase that took any time
+        bar = " " * int(start * scale)
+        bar += "e" * max(int(entry * scale), 1 if entry else 0)
+        bar += "=" * max(int(action * scale), 1 if action else 0)
+        bar += "x" * max(int(exit_ * scale), 1 if exit_ else 0)
+
+        flags = ""
+        if record["flags"] & TRACE_FLAG_RESET:
+            flags += " RESET"
+        if record["flags"] & TRACE_FLAG_LIMIT:
+            flags += " LIMIT"
+
+        print("  %-28s %10.3f %9.3f %9.3f %9.3f %7d  |%s%s" % (
+            symbol_name(symbols, record["command"])[:28], start / 1000.0, entry / 1000.0, action / 1000.0,
+            exit_ / 1000.0, record["iterations"], bar, flags))
+    print()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode a command trace dump (DEBUG_PORT 't') into per-turn waterfalls")
+    parser.add_argument("capture", help="binary capture of the dump ('-' for stdin)")
+    parser.add_argument("--elf", help="firmware image, to name commands")
+    parser.add_argument("--nm", default="arm-none-eabi-nm", help="nm to read the image with (default: %(default)s)")
+    parser.add_argument("--turn-start", type=lambda text: int(text, 0),
+                        help="address of " + TURN_START_SYMBOL + " (found in --elf if not given)")
+    parser.add_argument("--width", type=int, default=60, help="waterfall width in characters (default: %(default)s)")
+    args = parser.parse_args()
+
+    data = sys.stdin.buffer.read() if args.capture == "-" else open(args.capture, "rb").read()
+    header, records = parse_dump(data)
+
+    symbols = load_symbols(args.elf, args.nm) if args.elf else None
+    turn_start = args.turn_start
+    if (turn_start is None) and symbols and (TURN_START_SYMBOL in symbols[1]):
+        turn_start = symbols[0][symbols[1].index(TURN_START_SYMBOL)]
+    if turn_start is None:
+        print("warning: " + TURN_START_SYMBOL + " unknown (use --elf or --turn-start), showing one turn", file=sys.stderr)
+        turn_start = -1
+    turn_start &= ~1
+
+    print("%d records of %d bytes, %d dropped while dumping, dumped at %.3f s" % (
+        header["count"], header["record_size"], header["dropped"], header["now_us"] / 1e6))
+    print()
+
+    for number, turn in enumerate(split_turns(records, turn_start)):
+        print_turn(number, turn, symbols, args.width)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())